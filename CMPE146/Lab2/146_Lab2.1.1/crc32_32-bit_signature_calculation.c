@@ -53,11 +53,29 @@
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include <stdlib.h>
 
-#define CRC32_POLY              0xEDB88320
-#define CRC32_INIT              0xFFFFFFFF
+#include "crc32_engine.h"
+#include "crc32_hw.h"
+#include "crc32_arbiter.h"
+#include "crc_generic.h"
+#include "crc32_tree.h"
+#include "crc32_correct.h"
+#include "crc32_hashmap.h"
+#include "crc32_delta.h"
+
+#define TREE_BLOCK_SIZE         64
+#define CORRECT_STRIDE          32
+#define MAP_CAPACITY            128
+#define MAP_LOOKUPS             1000
+#define DELTA_BLOCK_SIZE        128
 
 static uint8_t myData[1024] = {0};
-static uint32_t calculateCRC32(uint8_t* data, uint32_t length);
+static uint32_t referenceNodes[CRC32_TREE_MAX_NODES(1024 / TREE_BLOCK_SIZE)];
+static uint32_t currentNodes[CRC32_TREE_MAX_NODES(1024 / TREE_BLOCK_SIZE)];
+static crc32_syndrome_entry syndromeTable[CRC32_CORRECT_ENTRIES(1024, CORRECT_STRIDE)];
+static uint32_t mapHashes[MAP_CAPACITY], mapValues[MAP_CAPACITY];
+static uint8_t mapKeys[MAP_CAPACITY * 4];
+static crc32_delta_sig deltaSigs[1024 / DELTA_BLOCK_SIZE];
+static uint8_t deltaReport[12 + 8 * (1024 / DELTA_BLOCK_SIZE)];
 
 volatile uint32_t hwCalculatedCRC, swCalculatedCRC;
 
@@ -115,6 +133,26 @@ uint32_t computeElapsedTimeInMicroseconds(const uint32_t t0, const uint32_t t1)
     return elapsedTimeInMicroseconds;
 }
 
+/* Time MAP_LOOKUPS lookups of 4-byte sensor IDs taken from myData */
+uint32_t timeMapLookups(crc32_hashmap_hash_fn hash) {
+    crc32_hashmap map;
+    uint32_t value;
+    int i;
+
+    crc32_hashmap_init(&map, mapHashes, mapValues, mapKeys, MAP_CAPACITY, 4, hash);
+    for (i = 0; i < MAP_CAPACITY / 2; i++) {
+        crc32_hashmap_put(&map, &myData[4 * i], i);
+    }
+
+    uint32_t t0 = getTimerValue();
+    for (i = 0; i < MAP_LOOKUPS; i++) {
+        crc32_hashmap_get(&map, &myData[4 * (i % (MAP_CAPACITY / 2))], &value);
+    }
+    uint32_t t1 = getTimerValue();
+
+    return computeElapsedTimeInMicroseconds(t0, t1);
+}
+
 //![Simple CRC32 Example] 
 int main(void)
 {
@@ -145,12 +183,14 @@ int main(void)
     /* Stop WDT */
     MAP_WDT_A_holdTimer();
 
+    /* crc32() and the HW contexts claim the CRC32 module through the arbiter */
+    crc32_arbiter_init();
+
     MAP_CRC32_setSeed(CRC32_INIT, CRC32_MODE);
 
     uint32_t hwChecksum_t0 = getTimerValue();
 
-    for (ii = 0; ii < lengthOfMyData; ii++)
-        MAP_CRC32_set8BitData(myData[ii], CRC32_MODE);
+    crc32_hw_feed(myData, lengthOfMyData);
 
 
     /* Getting the result from the hardware module */
@@ -177,12 +217,80 @@ int main(void)
     uint32_t speedup = swChecksumElapsedTime/hwChecksumElapsedTime;
     printf("\nSpeedup: %u times faster\n", speedup);
 
+    //  Streaming  ---------------------------------------------------------------
+    /* Same buffer fed in uneven fragments, interleaved on both engines */
+    crc32_ctx swCtx, hwCtx;
+    uint32_t fragmentLengths[] = {100, 411, 13};
+    uint32_t offset = 0;
+
+    crc32_ctx_init(&swCtx, CRC32_ENGINE_SW);
+    crc32_ctx_init(&hwCtx, CRC32_ENGINE_HW);
+
+    for (ii = 0; ii < sizeof(fragmentLengths)/sizeof(fragmentLengths[0]); ii++) {
+        crc32_ctx_update(&swCtx, &myData[offset], fragmentLengths[ii]);
+        crc32_ctx_update(&hwCtx, &myData[offset], fragmentLengths[ii]);
+        offset += fragmentLengths[ii];
+    }
+    crc32_ctx_update(&swCtx, &myData[offset], lengthOfMyData - offset);
+    crc32_ctx_update(&hwCtx, &myData[offset], lengthOfMyData - offset);
+
+    printf("\nStreaming Checksum: SW %u, HW %u\n", crc32_ctx_final(&swCtx), crc32_ctx_final(&hwCtx));
+
+    //  Combine  -----------------------------------------------------------------
+    /* First half on the CRC32 module, second half in software, merged */
+    uint32_t half = lengthOfMyData / 2;
+
+    crc32_ctx_init(&hwCtx, CRC32_ENGINE_HW);
+    crc32_ctx_update(&hwCtx, myData, half);
+
+    uint32_t combinedCRC = crc32_combine(crc32_ctx_final(&hwCtx),
+                                         calculateCRC32(&myData[half], lengthOfMyData - half),
+                                         lengthOfMyData - half);
+
+    printf("\nCombined Checksum: %u\n", combinedCRC);
+
+    //  Protocol CRCs  -----------------------------------------------------------
+    printf("\nCRC-8: %02x\nCRC-16-CCITT: %04x (%s)\nCRC-32C: %08x\n",
+           crc_calculate(&crc8Params, myData, lengthOfMyData),
+           crc_calculate(&crc16CcittParams, myData, lengthOfMyData),
+           crc_hw_supported(&crc16CcittParams) ? "hardware" : "software",
+           crc_calculate(&crc32cParams, myData, lengthOfMyData));
+
+    //  Hash map  ----------------------------------------------------------------
+    printf("\n%u map lookups: CRC32 hash %u us, FNV-1a %u us\n", MAP_LOOKUPS,
+           timeMapLookups(NULL), timeMapLookups(crc32_hashmap_fnv1a));
+
+    //  Delta signatures  --------------------------------------------------------
+    /* Block signatures for the host delta tool, signed as the data streams in */
+    crc32_delta_signer signer;
+
+    crc32_delta_sign_init(&signer, DELTA_BLOCK_SIZE, deltaSigs,
+                          sizeof(deltaSigs)/sizeof(deltaSigs[0]), CRC32_ENGINE_HW);
+    for (offset = 0; offset < lengthOfMyData; offset += 100)
+        crc32_delta_sign_update(&signer, &myData[offset],
+                                lengthOfMyData - offset < 100 ? lengthOfMyData - offset : 100);
+
+    uint32_t reportLength = crc32_delta_serialize(deltaSigs, crc32_delta_sign_final(&signer),
+                                                  DELTA_BLOCK_SIZE, deltaReport, sizeof(deltaReport));
+    printf("\nDelta signatures: %u blocks, %u byte report\n",
+           crc32_delta_sign_final(&signer), reportLength);
+
+    //  Block tree  --------------------------------------------------------------
+    /* Reference tree of the unmodified data, checked after Exercise 1.4 */
+    crc32_tree referenceTree, currentTree;
+
+    crc32_tree_init(&referenceTree, referenceNodes, lengthOfMyData, TREE_BLOCK_SIZE);
+    crc32_tree_build(&referenceTree, myData);
+
     //  Exercise 1.4  ------------------------------------------------------------
+    uint8_t oldByte = myData[20];
+
     myData[20] = myData[20] ^ 1;
     printf("\nReverse myData[20]:");
 
-    for (ii = 0; ii < lengthOfMyData; ii++)
-            MAP_CRC32_set8BitData(myData[ii], CRC32_MODE);
+    /* Fresh seed: the streaming and combine demos left their state behind */
+    MAP_CRC32_setSeed(CRC32_INIT, CRC32_MODE);
+    crc32_hw_feed(myData, lengthOfMyData);
 
     hwChecksum_t0 = getTimerValue();
 
@@ -194,6 +302,12 @@ int main(void)
     hwChecksumElapsedTime = computeElapsedTimeInMicroseconds(hwChecksum_t0, hwChecksum_t1);
     printf("\nHardware Checksum: %u\nElapsed Time: %u us\n", hwCalculatedCRC, hwChecksumElapsedTime);
 
+    /* Same result from the old CRC and the one changed byte */
+    uint32_t incrementalCRC = crc32_update_range(swCalculatedCRC, lengthOfMyData, 20,
+                                                 &oldByte, &myData[20], 1);
+    printf("Incremental Checksum: %u (%s)\n", incrementalCRC,
+           incrementalCRC == hwCalculatedCRC ? "match" : "MISMATCH");
+
     //  --------------------------------------------------------------------------
 
     simpleChecksum_t0 = getTimerValue();
@@ -210,10 +324,11 @@ int main(void)
     myData[21] = myData[21] ^ 1;
     printf("\nReverse myData[21]:");
 
+    MAP_CRC32_setSeed(CRC32_INIT, CRC32_MODE);
+
     hwChecksum_t0 = getTimerValue();
 
-    for (ii = 0; ii < lengthOfMyData; ii++)
-            MAP_CRC32_set8BitData(myData[ii], CRC32_MODE);
+    crc32_hw_feed(myData, lengthOfMyData);
 
     /* Getting the result from the hardware module */
     hwCalculatedCRC = MAP_CRC32_getResultReversed(CRC32_MODE) ^ 0xFFFFFFFF;
@@ -234,30 +349,36 @@ int main(void)
     simpleChecksumElapsedTime = computeElapsedTimeInMicroseconds(simpleChecksum_t0, simpleChecksum_t1);
     printf("\nSimple Checksum: %u\nElapsed Time: %u us\n", simpleChecksum, simpleChecksumElapsedTime);
 
-    /* Pause for the debugger */
-    __no_operation();
-}
-//![Simple CRC32 Example] 
+    //  Block tree  --------------------------------------------------------------
+    uint32_t badBlocks[4];
 
-/* Standard software calculation of CRC32 */
-static uint32_t calculateCRC32(uint8_t* data, uint32_t length)
-{
-    uint32_t ii, jj, byte, crc, mask;;
+    crc32_tree_init(&currentTree, currentNodes, lengthOfMyData, TREE_BLOCK_SIZE);
+    crc32_tree_build(&currentTree, myData);
 
-    crc = 0xFFFFFFFF;
+    uint32_t badCount = crc32_tree_diff(&currentTree, &referenceTree, badBlocks, 4);
+    printf("\nCorrupted blocks: %u", badCount);
+    for (ii = 0; ii < badCount && ii < 4; ii++)
+        printf(" [%u]", badBlocks[ii]);
+    printf("\n");
 
-    for(ii=0;ii<length;ii++)
-    {
-        byte = data[ii];
-        crc = crc ^ byte;
+    //  Single-bit correction  ---------------------------------------------------
+    crc32_corrector corrector;
+    int32_t fixedBit;
 
-        for (jj = 0; jj < 8; jj++)
-        {
-            mask = -(crc & 1);
-            crc = (crc >> 1) ^ (CRC32_POLY & mask);
-        }
+    crc32_correct_init(&corrector, syndromeTable, lengthOfMyData, CORRECT_STRIDE);
 
-    }
+    /* Two flipped bits are detected but cannot be repaired */
+    printf("\nCorrect two-bit error: %s\n",
+           crc32_correct(&corrector, myData, lengthOfMyData, crc32_tree_root(&referenceTree),
+                         &fixedBit) == CRC32_CORRECT_FAILED ? "rejected" : "unexpected");
 
-    return ~crc;
+    /* Undo the second flip and let the syndrome locate the first one */
+    myData[21] = myData[21] ^ 1;
+    if (crc32_correct(&corrector, myData, lengthOfMyData, crc32_tree_root(&referenceTree),
+                      &fixedBit) == CRC32_CORRECT_FIXED)
+        printf("Correct single-bit error: fixed myData[%d] bit %d\n", fixedBit / 8, fixedBit % 8);
+
+    /* Pause for the debugger */
+    __no_operation();
 }
+//![Simple CRC32 Example] 
@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * CRC32 module arbitration
+ *
+ * The owner token is claimed with an exclusive load/store pair. An interrupt
+ * between the two clears the exclusive monitor, so the store fails and the
+ * claim is retried; a client interrupted while it owns the module simply
+ * keeps it, and the interrupting client falls back to software.
+ *
+ * Only the owner touches acquiredAt and the hold counters. The contention
+ * counters can be hit by nested interrupts at once and are updated with the
+ * same exclusive access.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include <string.h>
+
+#include "crc32_arbiter.h"
+#include "crc32_engine.h"
+#include "crc32_hw.h"
+
+static const void * volatile owner;
+static uint32_t acquiredAt;
+static crc32_arbiter_counters counters;
+
+static void atomicIncrement(volatile uint32_t *counter)
+{
+    uint32_t value;
+
+    do
+    {
+        value = __LDREXW(counter) + 1;
+    } while (__STREXW(value, counter));
+}
+
+static void atomicMax(volatile uint32_t *counter, uint32_t value)
+{
+    do
+    {
+        if (__LDREXW(counter) >= value)
+        {
+            __CLREX();
+            return;
+        }
+    } while (__STREXW(value, counter));
+}
+
+void crc32_arbiter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    memset(&counters, 0, sizeof(counters));
+}
+
+bool crc32_arbiter_acquire(const void *client)
+{
+    do
+    {
+        if (__LDREXW((volatile uint32_t *)&owner) != 0)
+        {
+            __CLREX();
+            atomicIncrement(&counters.contentions);
+            return false;
+        }
+    } while (__STREXW((uint32_t)client, (volatile uint32_t *)&owner));
+
+    __DMB();
+    acquiredAt = DWT->CYCCNT;
+
+    return true;
+}
+
+void crc32_arbiter_release(const void *client)
+{
+    uint32_t held;
+
+    if (owner != client)
+        return;
+
+    held = DWT->CYCCNT - acquiredAt;
+    counters.grants++;
+    counters.holdCycles += held;
+    if (held > counters.maxHoldCycles)
+        counters.maxHoldCycles = held;
+
+    __DMB();
+    owner = 0;
+}
+
+const void *crc32_arbiter_owner(void)
+{
+    return owner;
+}
+
+uint32_t crc32_arbiter_update(const void *client, uint32_t crc,
+                              const uint8_t *data, uint32_t length)
+{
+    uint32_t t0;
+
+    if (crc32_arbiter_acquire(client))
+    {
+        crc = crc32_hw_update(crc, data, length);
+        crc32_arbiter_release(client);
+
+        return crc;
+    }
+
+    t0 = DWT->CYCCNT;
+    crc = crc32_update(crc, data, length);
+
+    atomicMax(&counters.maxFallbackCycles, DWT->CYCCNT - t0);
+
+    return crc;
+}
+
+const crc32_arbiter_counters *crc32_arbiter_stats(void)
+{
+    return &counters;
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * CRC32 single-bit error correction
+ ******************************************************************************/
+#include <stdlib.h>
+
+#include "crc32_correct.h"
+#include "crc32_engine.h"
+
+/* Multiply by x in the reflected representation: one zero bit through the
+ * CRC register */
+static uint32_t mulx(uint32_t value)
+{
+    return (value & 1) ? (value >> 1) ^ CRC32_POLY : value >> 1;
+}
+
+static int compareEntries(const void *a, const void *b)
+{
+    uint32_t sa = ((const crc32_syndrome_entry *)a)->syndrome;
+    uint32_t sb = ((const crc32_syndrome_entry *)b)->syndrome;
+
+    return (sa > sb) - (sa < sb);
+}
+
+static const crc32_syndrome_entry *findEntry(const crc32_corrector *corrector, uint32_t syndrome)
+{
+    uint32_t lo = 0, hi = corrector->count;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+
+        if (corrector->entries[mid].syndrome < syndrome)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < corrector->count && corrector->entries[lo].syndrome == syndrome)
+        return &corrector->entries[lo];
+
+    return 0;
+}
+
+void crc32_correct_init(crc32_corrector *corrector, crc32_syndrome_entry *entries,
+                        uint32_t maxLength, uint32_t stride)
+{
+    uint32_t value = CRC32_POLY;            /* x^32 mod P */
+    uint32_t g, ii;
+
+    corrector->entries = entries;
+    corrector->count = CRC32_CORRECT_ENTRIES(maxLength, stride);
+    corrector->stride = stride;
+    corrector->maxBits = 8 * maxLength;
+
+    for (g = 0; g < corrector->count; g++)
+    {
+        entries[g].syndrome = value;
+        entries[g].step = g;
+
+        for (ii = 0; ii < stride; ii++)
+            value = mulx(value);
+    }
+
+    qsort(entries, corrector->count, sizeof(entries[0]), compareEntries);
+}
+
+int32_t crc32_correct_locate(const crc32_corrector *corrector, uint32_t length,
+                             uint32_t syndrome)
+{
+    uint32_t bits = 8 * length;
+    uint32_t k;
+
+    if (syndrome == 0 || bits == 0 || bits > corrector->maxBits)
+        return -1;
+
+    /* syndrome * x^k == x^(32 + g * stride)  =>  d = g * stride - k */
+    for (k = 0; k < corrector->stride; k++)
+    {
+        const crc32_syndrome_entry *entry = findEntry(corrector, syndrome);
+
+        if (entry)
+        {
+            uint32_t reach = entry->step * corrector->stride;
+
+            if (reach >= k && reach - k < bits)
+                return (int32_t)(bits - 1 - (reach - k));
+
+            return -1;
+        }
+
+        syndrome = mulx(syndrome);
+    }
+
+    return -1;
+}
+
+crc32_correct_result crc32_correct(const crc32_corrector *corrector, uint8_t *data,
+                                   uint32_t length, uint32_t expectedCrc, int32_t *bitIndex)
+{
+    uint32_t syndrome = calculateCRC32(data, length) ^ expectedCrc;
+    int32_t bit;
+
+    if (syndrome == 0)
+        return CRC32_CORRECT_OK;
+
+    /* Data syndromes are never a single register bit, so a one-bit
+     * syndrome can only come from the stored CRC itself */
+    if ((syndrome & (syndrome - 1)) == 0)
+        return CRC32_CORRECT_CRC_FIELD;
+
+    bit = crc32_correct_locate(corrector, length, syndrome);
+    if (bit < 0)
+        return CRC32_CORRECT_FAILED;
+
+    data[bit / 8] ^= 1 << (bit % 8);
+
+    if (bitIndex)
+        *bitIndex = bit;
+
+    return CRC32_CORRECT_FIXED;
+}
+
+int32_t crc32_correct_bruteforce(uint8_t *data, uint32_t length, uint32_t expectedCrc)
+{
+    uint32_t bit;
+
+    for (bit = 0; bit < 8 * length; bit++)
+    {
+        data[bit / 8] ^= 1 << (bit % 8);
+
+        uint32_t crc = calculateCRC32(data, length);
+
+        data[bit / 8] ^= 1 << (bit % 8);
+
+        if (crc == expectedCrc)
+            return (int32_t)bit;
+    }
+
+    return -1;
+}
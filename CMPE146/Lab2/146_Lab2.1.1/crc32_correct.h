@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * CRC32 single-bit error correction
+ *
+ * Flipping bit i of an L-byte message changes its CRC32 by a syndrome that
+ * only depends on the distance d = 8L - 1 - i to the end of the message:
+ * syndrome = x^(32 + d) mod P. For messages up to maxLength bytes all these
+ * syndromes are distinct, so the syndrome of a corrupted message identifies
+ * the flipped bit and the error can be repaired in place.
+ *
+ * The syndrome-to-position lookup is a baby-step/giant-step table: it stores
+ * x^(32 + g * stride) for every giant step g, sorted, and a lookup shifts the
+ * syndrome at most stride - 1 times, with a binary search after each shift.
+ * stride = 1 is a plain lookup table with one entry per bit position;
+ * a larger stride divides the table size by stride at the cost of up to
+ * stride searches. Table storage comes from the caller, sized with
+ * CRC32_CORRECT_ENTRIES(). Builds for the host as well.
+ ******************************************************************************/
+#ifndef CRC32_CORRECT_H_
+#define CRC32_CORRECT_H_
+
+#include <stdint.h>
+
+/* Table entries needed for messages up to maxLength bytes */
+#define CRC32_CORRECT_ENTRIES(maxLength, stride) \
+    ((8 * (maxLength) + (stride) - 2) / (stride) + 1)
+
+typedef struct
+{
+    uint32_t syndrome;
+    uint32_t step;
+} crc32_syndrome_entry;
+
+typedef struct
+{
+    crc32_syndrome_entry *entries;
+    uint32_t count;
+    uint32_t stride;
+    uint32_t maxBits;
+} crc32_corrector;
+
+typedef enum
+{
+    CRC32_CORRECT_OK,           /* CRC matches, nothing to do */
+    CRC32_CORRECT_FIXED,        /* one data bit was flipped back */
+    CRC32_CORRECT_CRC_FIELD,    /* data is fine, the expected CRC has one bad bit */
+    CRC32_CORRECT_FAILED        /* not a single-bit error */
+} crc32_correct_result;
+
+/* Build the lookup table for messages up to maxLength bytes */
+void crc32_correct_init(crc32_corrector *corrector, crc32_syndrome_entry *entries,
+                        uint32_t maxLength, uint32_t stride);
+
+/* Bit index (8 * byte + bit, LSB first) of the single-bit error behind
+ * syndrome in a length-byte message, or -1 if there is none */
+int32_t crc32_correct_locate(const crc32_corrector *corrector, uint32_t length,
+                             uint32_t syndrome);
+
+/* Check data against expectedCrc and repair a single-bit error in place.
+ * bitIndex (optional) receives the repaired bit. */
+crc32_correct_result crc32_correct(const crc32_corrector *corrector, uint8_t *data,
+                                   uint32_t length, uint32_t expectedCrc, int32_t *bitIndex);
+
+/* Reference search: flip every bit in turn and recompute the CRC */
+int32_t crc32_correct_bruteforce(uint8_t *data, uint32_t length, uint32_t expectedCrc);
+
+#endif /* CRC32_CORRECT_H_ */
@@ -0,0 +1,214 @@
+/*******************************************************************************
+ * Rolling-checksum delta updates
+ ******************************************************************************/
+#include <string.h>
+
+#include "crc32_delta.h"
+
+static void putLE32(uint8_t *out, uint32_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+}
+
+static uint32_t getLE32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) |
+           ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static uint32_t packWeak(uint32_t a, uint32_t b)
+{
+    return (a & 0xFFFF) | (b << 16);
+}
+
+uint32_t crc32_delta_weak(const uint8_t *data, uint32_t length)
+{
+    uint32_t a = 0, b = 0;
+
+    while (length--)
+    {
+        a += *data++;
+        b += a;
+    }
+
+    return packWeak(a, b);
+}
+
+uint32_t crc32_delta_roll(uint32_t weak, uint8_t out, uint8_t in, uint32_t blockSize)
+{
+    uint32_t a = (weak & 0xFFFF) - out + in;
+    uint32_t b = (weak >> 16) - blockSize * out + a;
+
+    return packWeak(a, b);
+}
+
+void crc32_delta_sign_init(crc32_delta_signer *signer, uint32_t blockSize,
+                           crc32_delta_sig *sigs, uint32_t maxSigs, crc32_engine_t engine)
+{
+    signer->blockSize = blockSize;
+    signer->fill = 0;
+    signer->a = 0;
+    signer->b = 0;
+    signer->sigs = sigs;
+    signer->maxSigs = maxSigs;
+    signer->count = 0;
+    crc32_ctx_init(&signer->strong, engine);
+}
+
+void crc32_delta_sign_update(crc32_delta_signer *signer, const uint8_t *data, uint32_t length)
+{
+    while (length)
+    {
+        uint32_t chunk = signer->blockSize - signer->fill;
+        uint32_t ii;
+
+        if (chunk > length)
+            chunk = length;
+
+        for (ii = 0; ii < chunk; ii++)
+        {
+            signer->a += data[ii];
+            signer->b += signer->a;
+        }
+
+        crc32_ctx_update(&signer->strong, data, chunk);
+        signer->fill += chunk;
+        data += chunk;
+        length -= chunk;
+
+        if (signer->fill == signer->blockSize)
+        {
+            if (signer->count < signer->maxSigs)
+            {
+                signer->sigs[signer->count].weak = packWeak(signer->a, signer->b);
+                signer->sigs[signer->count].strong = crc32_ctx_final(&signer->strong);
+            }
+            signer->count++;
+
+            signer->fill = 0;
+            signer->a = 0;
+            signer->b = 0;
+            crc32_ctx_init(&signer->strong, signer->strong.engine);
+        }
+    }
+}
+
+uint32_t crc32_delta_sign_final(crc32_delta_signer *signer)
+{
+    return signer->count < signer->maxSigs ? signer->count : signer->maxSigs;
+}
+
+uint32_t crc32_delta_serialize(const crc32_delta_sig *sigs, uint32_t count, uint32_t blockSize,
+                               uint8_t *out, uint32_t size)
+{
+    uint32_t total = 12 + 8 * count;
+    uint32_t ii;
+
+    if (size < total)
+        return 0;
+
+    putLE32(out, CRC32_DELTA_SIG_MAGIC);
+    putLE32(out + 4, blockSize);
+    putLE32(out + 8, count);
+
+    for (ii = 0; ii < count; ii++)
+    {
+        putLE32(out + 12 + 8 * ii, sigs[ii].weak);
+        putLE32(out + 16 + 8 * ii, sigs[ii].strong);
+    }
+
+    return total;
+}
+
+int32_t crc32_delta_deserialize(const uint8_t *in, uint32_t size, uint32_t *blockSize,
+                                crc32_delta_sig *sigs, uint32_t maxSigs)
+{
+    uint32_t count, ii;
+
+    if (size < 12 || getLE32(in) != CRC32_DELTA_SIG_MAGIC)
+        return -1;
+
+    *blockSize = getLE32(in + 4);
+    count = getLE32(in + 8);
+
+    if (*blockSize == 0 || count > maxSigs || (size - 12) / 8 < count)
+        return -1;
+
+    for (ii = 0; ii < count; ii++)
+    {
+        sigs[ii].weak = getLE32(in + 12 + 8 * ii);
+        sigs[ii].strong = getLE32(in + 16 + 8 * ii);
+    }
+
+    return (int32_t)count;
+}
+
+int32_t crc32_delta_apply(const uint8_t *old, uint32_t oldLength,
+                          const uint8_t *delta, uint32_t deltaLength,
+                          uint8_t *out, uint32_t outSize)
+{
+    const uint8_t *p = delta + CRC32_DELTA_HEADER_SIZE;
+    const uint8_t *end = delta + deltaLength;
+    uint32_t blockSize, newLength, newCrc;
+    uint32_t written = 0;
+
+    if (deltaLength < CRC32_DELTA_HEADER_SIZE || getLE32(delta) != CRC32_DELTA_MAGIC)
+        return -1;
+
+    blockSize = getLE32(delta + 4);
+    newLength = getLE32(delta + 8);
+    newCrc = getLE32(delta + 12);
+
+    if (blockSize == 0 || newLength > outSize)
+        return -1;
+
+    while (p < end)
+    {
+        uint8_t op = *p++;
+        uint32_t first, count, length;
+
+        if (op == CRC32_DELTA_OP_COPY)
+        {
+            if (end - p < 8)
+                return -1;
+            first = getLE32(p);
+            count = getLE32(p + 4);
+            p += 8;
+
+            if (first > oldLength / blockSize || count > oldLength / blockSize - first)
+                return -1;
+            length = count * blockSize;
+            if (length > newLength - written)
+                return -1;
+
+            memcpy(out + written, old + first * blockSize, length);
+        }
+        else if (op == CRC32_DELTA_OP_LITERAL)
+        {
+            if (end - p < 4)
+                return -1;
+            length = getLE32(p);
+            p += 4;
+
+            if (length > (uint32_t)(end - p) || length > newLength - written)
+                return -1;
+
+            memcpy(out + written, p, length);
+            p += length;
+        }
+        else
+        {
+            return -1;
+        }
+
+        written += length;
+    }
+
+    if (written != newLength || calculateCRC32(out, newLength) != newCrc)
+        return -1;
+
+    return (int32_t)newLength;
+}
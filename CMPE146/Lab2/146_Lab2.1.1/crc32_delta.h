@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Rolling-checksum delta updates
+ *
+ * rsync-style incremental image updates over a slow link. The device splits
+ * its current image into fixed-size blocks and reports one signature per
+ * block: a weak rolling checksum and the CRC32 as strong confirmation. The
+ * host slides a window over the new image; the weak checksum of the window
+ * rolls forward one byte in O(1), and only windows whose weak checksum
+ * matches a signature get a CRC32. Matching blocks are sent as references,
+ * everything else as literal bytes (tools/crc32_delta.c builds the delta).
+ *
+ * The weak checksum is rsync's: a = sum of the bytes, b = sum of the running
+ * a values, both mod 2^16, packed as a | b << 16. The signer takes the image
+ * in fragments of any size with O(1) work per byte, so it can run while the
+ * image streams past, e.g. from flash through a small buffer.
+ *
+ * Delta format, little-endian:
+ *     header  "CRCD", block size, new length, CRC32 of the new image
+ *     'C'     first block, block count: copy blocks of the old image
+ *     'L'     length, bytes: literal data
+ * crc32_delta_apply() rebuilds the new image and checks its CRC32.
+ *
+ * Builds for the host as well.
+ ******************************************************************************/
+#ifndef CRC32_DELTA_H_
+#define CRC32_DELTA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "crc32_engine.h"
+
+#define CRC32_DELTA_SIG_MAGIC   0x53435243      /* "CRCS" */
+#define CRC32_DELTA_MAGIC       0x44435243      /* "CRCD" */
+#define CRC32_DELTA_HEADER_SIZE 16
+#define CRC32_DELTA_OP_COPY     'C'
+#define CRC32_DELTA_OP_LITERAL  'L'
+
+typedef struct
+{
+    uint32_t weak;
+    uint32_t strong;            /* CRC32 of the block */
+} crc32_delta_sig;
+
+typedef struct
+{
+    uint32_t blockSize;
+    uint32_t fill;              /* bytes of the current block seen so far */
+    uint32_t a, b;
+    crc32_ctx strong;
+    crc32_delta_sig *sigs;
+    uint32_t maxSigs;
+    uint32_t count;
+} crc32_delta_signer;
+
+/* Weak checksum of a whole block */
+uint32_t crc32_delta_weak(const uint8_t *data, uint32_t length);
+
+/* Slide a blockSize window one byte: drop out at the front, append in */
+uint32_t crc32_delta_roll(uint32_t weak, uint8_t out, uint8_t in, uint32_t blockSize);
+
+/* Streaming signatures of blockSize blocks into sigs (maxSigs entries) */
+void crc32_delta_sign_init(crc32_delta_signer *signer, uint32_t blockSize,
+                           crc32_delta_sig *sigs, uint32_t maxSigs, crc32_engine_t engine);
+void crc32_delta_sign_update(crc32_delta_signer *signer, const uint8_t *data, uint32_t length);
+
+/* Number of signatures; a trailing partial block is not signed */
+uint32_t crc32_delta_sign_final(crc32_delta_signer *signer);
+
+/* Report for the host: "CRCS", block size, count, then weak/strong pairs.
+ * Returns bytes written, 0 if out is too small. */
+uint32_t crc32_delta_serialize(const crc32_delta_sig *sigs, uint32_t count, uint32_t blockSize,
+                               uint8_t *out, uint32_t size);
+
+/* Parse a report into sigs; returns the count, -1 if malformed or too big */
+int32_t crc32_delta_deserialize(const uint8_t *in, uint32_t size, uint32_t *blockSize,
+                                crc32_delta_sig *sigs, uint32_t maxSigs);
+
+/* Rebuild the new image from the old one and a delta. Returns the new
+ * length, or -1 if the delta is malformed, out is too small or the result
+ * fails its CRC32. */
+int32_t crc32_delta_apply(const uint8_t *old, uint32_t oldLength,
+                          const uint8_t *delta, uint32_t deltaLength,
+                          uint8_t *out, uint32_t outSize);
+
+#endif /* CRC32_DELTA_H_ */
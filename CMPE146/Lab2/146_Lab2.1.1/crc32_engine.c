@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * CRC32 software engine
+ *
+ * All kernels share the flash-resident tables from crc32_tables.h. Only the
+ * tables of the configured CRC32_TABLE_TIER are compiled in, and only the
+ * kernels that can run on them.
+ ******************************************************************************/
+#include "crc32_engine.h"
+#include "crc32_tables.h"
+
+#if defined(__MSP432P401R__)
+#include "crc32_hw.h"
+#include "crc32_arbiter.h"
+#endif
+
+/* x^(2^k) mod P in reflected form for k = 0..31, so x^(8*lenB) costs one
+ * multiplication per bit set in lenB and a power-of-two segment (512, 1024,
+ * 4096, ...) costs a single one. x^(2^32) = x, so the table wraps around. */
+static const uint32_t crc32PowerTable[32] =
+{
+    0x40000000, 0x20000000, 0x08000000, 0x00800000,
+    0x00008000, 0xedb88320, 0xb1e6b092, 0xa06a2517,
+    0xed627dae, 0x88d14467, 0xd7bbfe6a, 0xec447f11,
+    0x8e7ea170, 0x6427800e, 0x4d47bae0, 0x09fe548f,
+    0x83852d0f, 0x30362f1a, 0x7b5a9cc3, 0x31fec169,
+    0x9fec022a, 0x6c8dedc4, 0x15d6874d, 0x5fde7a4e,
+    0xbad90e37, 0x2e4e5eef, 0x4eaba214, 0xa8a472c0,
+    0x429a969e, 0x148d302a, 0xc40ba6d0, 0xc4e22c3c
+};
+
+uint32_t crc32_update_bitwise(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    uint32_t ii, jj, mask;
+
+    for (ii = 0; ii < length; ii++)
+    {
+        crc = crc ^ data[ii];
+
+        for (jj = 0; jj < 8; jj++)
+        {
+            mask = -(crc & 1);
+            crc = (crc >> 1) ^ (CRC32_POLY & mask);
+        }
+    }
+
+    return crc;
+}
+
+uint32_t crc32_update_nibble(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--)
+    {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crc32NibbleTable[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32NibbleTable[crc & 0x0F];
+    }
+
+    return crc;
+}
+
+#if CRC32_TABLE_TIER >= CRC32_TIER_BYTE
+uint32_t crc32_update_bytewise(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length--)
+        crc = (crc >> 8) ^ crc32Table[0][(crc ^ *data++) & 0xFF];
+
+    return crc;
+}
+#endif
+
+#if CRC32_TABLE_TIER == CRC32_TIER_SLICE8
+uint32_t crc32_update_slice4(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length >= 4)
+    {
+        crc ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+               ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+
+        crc = crc32Table[3][crc & 0xFF] ^
+              crc32Table[2][(crc >> 8) & 0xFF] ^
+              crc32Table[1][(crc >> 16) & 0xFF] ^
+              crc32Table[0][crc >> 24];
+
+        data += 4;
+        length -= 4;
+    }
+
+    return crc32_update_bytewise(crc, data, length);
+}
+
+uint32_t crc32_update_slice8(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length >= 8)
+    {
+        crc ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+               ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+
+        crc = crc32Table[7][crc & 0xFF] ^
+              crc32Table[6][(crc >> 8) & 0xFF] ^
+              crc32Table[5][(crc >> 16) & 0xFF] ^
+              crc32Table[4][crc >> 24] ^
+              crc32Table[3][data[4]] ^
+              crc32Table[2][data[5]] ^
+              crc32Table[1][data[6]] ^
+              crc32Table[0][data[7]];
+
+        data += 8;
+        length -= 8;
+    }
+
+    return crc32_update_bytewise(crc, data, length);
+}
+#endif
+
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+#if CRC32_TABLE_TIER == CRC32_TIER_SLICE8
+    return crc32_update_slice8(crc, data, length);
+#elif CRC32_TABLE_TIER == CRC32_TIER_BYTE
+    return crc32_update_bytewise(crc, data, length);
+#else
+    return crc32_update_nibble(crc, data, length);
+#endif
+}
+
+/* Standard software calculation of CRC32 */
+uint32_t calculateCRC32(uint8_t* data, uint32_t length)
+{
+    return ~crc32_update(CRC32_INIT, data, length);
+}
+
+void crc32_ctx_init(crc32_ctx *ctx, crc32_engine_t engine)
+{
+    ctx->crc = CRC32_INIT;
+    ctx->length = 0;
+#if defined(__MSP432P401R__)
+    ctx->engine = engine;
+#else
+    (void)engine;
+    ctx->engine = CRC32_ENGINE_SW;
+#endif
+}
+
+void crc32_ctx_update(crc32_ctx *ctx, const uint8_t *data, uint32_t length)
+{
+#if defined(__MSP432P401R__)
+    if (ctx->engine == CRC32_ENGINE_HW)
+        ctx->crc = crc32_hw_update(ctx->crc, data, length);
+    else if (ctx->engine == CRC32_ENGINE_SHARED)
+        ctx->crc = crc32_arbiter_update(ctx, ctx->crc, data, length);
+    else
+#endif
+        ctx->crc = crc32_update(ctx->crc, data, length);
+
+    ctx->length += length;
+}
+
+uint32_t crc32_ctx_final(const crc32_ctx *ctx)
+{
+    return ~ctx->crc;
+}
+
+/* a * b mod P over GF(2). Multiplying by a fixed polynomial is the same as
+ * applying the 32x32 GF(2) matrix of that polynomial, one row per set bit. */
+static uint32_t crc32_multmodp(uint32_t a, uint32_t b)
+{
+    uint32_t m = (uint32_t)1 << 31;
+    uint32_t p = 0;
+
+    for (;;)
+    {
+        if (a & m)
+        {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32_POLY : b >> 1;
+    }
+
+    return p;
+}
+
+/* x^(n * 2^k) mod P, by square-and-multiply over crc32PowerTable */
+static uint32_t crc32_x2nmodp(uint32_t n, uint32_t k)
+{
+    uint32_t p = (uint32_t)1 << 31;     /* x^0 */
+
+    while (n)
+    {
+        if (n & 1)
+            p = crc32_multmodp(crc32PowerTable[k & 31], p);
+        n >>= 1;
+        k++;
+    }
+
+    return p;
+}
+
+uint32_t crc32_combine(uint32_t crcA, uint32_t crcB, uint32_t lenB)
+{
+    /* Shift crcA past lenB zero bytes (k = 3: 8 bits per byte) */
+    return crc32_multmodp(crc32_x2nmodp(lenB, 3), crcA) ^ crcB;
+}
+
+uint32_t crc32_update_range(uint32_t oldCrc, uint32_t totalLength, uint32_t offset,
+                            const uint8_t *oldBytes, const uint8_t *newBytes, uint32_t length)
+{
+    uint8_t delta[16];
+    uint32_t diff = 0;
+    uint32_t done, chunk, ii;
+
+    /* The shift below assumes the range lies inside the buffer */
+    if (offset > totalLength || length > totalLength - offset)
+        return oldCrc;
+
+    /* Raw CRC of the XOR delta, seeded with 0 so only the change counts */
+    for (done = 0; done < length; done += chunk)
+    {
+        chunk = (length - done < sizeof(delta)) ? length - done : sizeof(delta);
+
+        for (ii = 0; ii < chunk; ii++)
+            delta[ii] = oldBytes[done + ii] ^ newBytes[done + ii];
+
+        diff = crc32_update(diff, delta, chunk);
+    }
+
+    /* Shift it past the unchanged bytes behind the range */
+    return oldCrc ^ crc32_multmodp(crc32_x2nmodp(totalLength - offset - length, 3), diff);
+}
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ * CRC32-hashed key/value map
+ ******************************************************************************/
+#include <string.h>
+
+#include "crc32_hashmap.h"
+#include "crc32_engine.h"
+
+#if defined(__MSP432P401R__)
+#include "crc32_arbiter.h"
+#endif
+
+uint32_t crc32_hash(const void *key, uint32_t length)
+{
+#if defined(__MSP432P401R__)
+    static const char client = 0;
+
+    return ~crc32_arbiter_update(&client, CRC32_INIT, key, length);
+#else
+    return ~crc32_update(CRC32_INIT, key, length);
+#endif
+}
+
+uint32_t crc32_hashmap_fnv1a(const void *key, uint32_t length)
+{
+    const uint8_t *p = key;
+    uint32_t hash = 0x811C9DC5;
+
+    while (length--)
+        hash = (hash ^ *p++) * 0x01000193;
+
+    return hash;
+}
+
+static uint32_t slotHash(const crc32_hashmap *map, const void *key)
+{
+    uint32_t hash = map->hash(key, map->keySize);
+
+    return hash == CRC32_HASHMAP_EMPTY ? 1 : hash;
+}
+
+static uint8_t *slotKey(const crc32_hashmap *map, uint32_t slot)
+{
+    return &map->keys[slot * map->keySize];
+}
+
+/* Slot holding key, or the empty slot that ends its probe sequence */
+static uint32_t findSlot(const crc32_hashmap *map, const void *key, uint32_t hash)
+{
+    uint32_t mask = map->capacity - 1;
+    uint32_t slot = hash & mask;
+
+    while (map->hashes[slot] != CRC32_HASHMAP_EMPTY)
+    {
+        if (map->hashes[slot] == hash && memcmp(slotKey(map, slot), key, map->keySize) == 0)
+            break;
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void crc32_hashmap_init(crc32_hashmap *map, uint32_t *hashes, uint32_t *values, uint8_t *keys,
+                        uint32_t capacity, uint32_t keySize, crc32_hashmap_hash_fn hash)
+{
+    map->hashes = hashes;
+    map->values = values;
+    map->keys = keys;
+    map->capacity = capacity;
+    map->keySize = keySize;
+    map->count = 0;
+    map->hash = hash ? hash : crc32_hash;
+
+    memset(hashes, 0, capacity * sizeof(hashes[0]));
+}
+
+bool crc32_hashmap_put(crc32_hashmap *map, const void *key, uint32_t value)
+{
+    uint32_t hash = slotHash(map, key);
+    uint32_t slot = findSlot(map, key, hash);
+
+    if (map->hashes[slot] == CRC32_HASHMAP_EMPTY)
+    {
+        if (4 * (map->count + 1) > 3 * map->capacity)
+            return false;
+
+        map->hashes[slot] = hash;
+        memcpy(slotKey(map, slot), key, map->keySize);
+        map->count++;
+    }
+
+    map->values[slot] = value;
+    return true;
+}
+
+bool crc32_hashmap_get(const crc32_hashmap *map, const void *key, uint32_t *value)
+{
+    uint32_t slot = findSlot(map, key, slotHash(map, key));
+
+    if (map->hashes[slot] == CRC32_HASHMAP_EMPTY)
+        return false;
+
+    if (value)
+        *value = map->values[slot];
+    return true;
+}
+
+bool crc32_hashmap_remove(crc32_hashmap *map, const void *key)
+{
+    uint32_t mask = map->capacity - 1;
+    uint32_t hole = findSlot(map, key, slotHash(map, key));
+    uint32_t slot = hole;
+
+    if (map->hashes[hole] == CRC32_HASHMAP_EMPTY)
+        return false;
+
+    /* Backward shift: move every following entry whose home slot is not
+     * between the hole and itself into the hole */
+    for (;;)
+    {
+        uint32_t home;
+
+        slot = (slot + 1) & mask;
+        if (map->hashes[slot] == CRC32_HASHMAP_EMPTY)
+            break;
+
+        home = map->hashes[slot] & mask;
+        if (((slot - home) & mask) < ((slot - hole) & mask))
+            continue;
+
+        map->hashes[hole] = map->hashes[slot];
+        map->values[hole] = map->values[slot];
+        memcpy(slotKey(map, hole), slotKey(map, slot), map->keySize);
+        hole = slot;
+    }
+
+    map->hashes[hole] = CRC32_HASHMAP_EMPTY;
+    map->count--;
+    return true;
+}
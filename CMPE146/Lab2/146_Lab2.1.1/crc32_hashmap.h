@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * CRC32-hashed key/value map
+ *
+ * Open addressing with linear probing over a power-of-two number of slots,
+ * for fixed-size keys (session IDs, sensor IDs, ...) and 32-bit values. All
+ * storage comes from the caller: capacity hashes and values and
+ * capacity * keySize key bytes. Each slot keeps the full 32-bit hash, so a
+ * probe only compares keys when the hashes match, and removal shifts the
+ * following entries back instead of leaving tombstones. Inserts are refused
+ * above 3/4 load to keep probe sequences short.
+ *
+ * The default hash is crc32_hash(): the CRC32 module when it is free (claimed
+ * through crc32_arbiter.h), the table-driven software engine otherwise and
+ * on the host. Any other hash, such as crc32_hashmap_fnv1a() for comparison,
+ * can be passed to crc32_hashmap_init().
+ ******************************************************************************/
+#ifndef CRC32_HASHMAP_H_
+#define CRC32_HASHMAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Hash value marking an unused slot; real hashes of 0 are stored as 1 */
+#define CRC32_HASHMAP_EMPTY     0
+
+typedef uint32_t (*crc32_hashmap_hash_fn)(const void *key, uint32_t length);
+
+typedef struct
+{
+    uint32_t *hashes;
+    uint32_t *values;
+    uint8_t *keys;
+    uint32_t capacity;          /* power of two */
+    uint32_t keySize;
+    uint32_t count;
+    crc32_hashmap_hash_fn hash;
+} crc32_hashmap;
+
+/* CRC32 of the key, on the CRC32 module if it is free */
+uint32_t crc32_hash(const void *key, uint32_t length);
+
+/* 32-bit FNV-1a */
+uint32_t crc32_hashmap_fnv1a(const void *key, uint32_t length);
+
+/* Empty map over caller storage; hash NULL selects crc32_hash() */
+void crc32_hashmap_init(crc32_hashmap *map, uint32_t *hashes, uint32_t *values, uint8_t *keys,
+                        uint32_t capacity, uint32_t keySize, crc32_hashmap_hash_fn hash);
+
+/* Insert or overwrite; false if the map is at its load limit */
+bool crc32_hashmap_put(crc32_hashmap *map, const void *key, uint32_t value);
+
+/* Look up key; value may be NULL to only test for presence */
+bool crc32_hashmap_get(const crc32_hashmap *map, const void *key, uint32_t *value);
+
+/* Remove key; false if it was not there */
+bool crc32_hashmap_remove(crc32_hashmap *map, const void *key);
+
+#endif /* CRC32_HASHMAP_H_ */
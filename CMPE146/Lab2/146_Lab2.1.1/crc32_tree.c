@@ -0,0 +1,216 @@
+/*******************************************************************************
+ * CRC32 block tree
+ *
+ * Level k holds ceil(leafCount / 2^k) nodes; node i of level k covers blocks
+ * [i * 2^k, (i + 1) * 2^k). A node without a right sibling is copied up
+ * unchanged, so the root always covers the whole buffer.
+ ******************************************************************************/
+#include "crc32_tree.h"
+#include "crc32_engine.h"
+
+#define CRC32_TREE_MAX_LEVELS   33
+
+/* Offset of every level in the node array; returns the number of levels */
+static uint32_t levelOffsets(const crc32_tree *tree, uint32_t *offsets, uint32_t *counts)
+{
+    uint32_t count = tree->leafCount;
+    uint32_t offset = 0;
+    uint32_t levels = 0;
+
+    while (count)
+    {
+        offsets[levels] = offset;
+        counts[levels] = count;
+        levels++;
+        offset += count;
+
+        if (count == 1)
+            break;
+        count = (count + 1) / 2;
+    }
+
+    return levels;
+}
+
+/* Bytes covered by node index of the given level */
+static uint32_t nodeLength(const crc32_tree *tree, uint32_t level, uint32_t index)
+{
+    uint64_t span = (uint64_t)tree->blockSize << level;
+    uint64_t start = span * index;
+    uint64_t remaining = tree->length - start;
+
+    return (uint32_t)(remaining < span ? remaining : span);
+}
+
+static void combineNode(crc32_tree *tree, const uint32_t *offsets, const uint32_t *counts,
+                        uint32_t level, uint32_t index)
+{
+    const uint32_t *children = &tree->nodes[offsets[level - 1]];
+    uint32_t left = 2 * index;
+    uint32_t crc = children[left];
+
+    if (left + 1 < counts[level - 1])
+        crc = crc32_combine(crc, children[left + 1], nodeLength(tree, level - 1, left + 1));
+
+    tree->nodes[offsets[level] + index] = crc;
+}
+
+static uint32_t diffNode(const crc32_tree *tree, const crc32_tree *reference,
+                         const uint32_t *offsets, const uint32_t *counts,
+                         uint32_t level, uint32_t index,
+                         uint32_t *badBlocks, uint32_t maxBad, uint32_t found)
+{
+    uint32_t node = offsets[level] + index;
+
+    if (tree->nodes[node] == reference->nodes[node])
+        return found;
+
+    if (level == 0)
+    {
+        if (found < maxBad)
+            badBlocks[found] = index;
+        return found + 1;
+    }
+
+    found = diffNode(tree, reference, offsets, counts, level - 1, 2 * index,
+                     badBlocks, maxBad, found);
+    if (2 * index + 1 < counts[level - 1])
+        found = diffNode(tree, reference, offsets, counts, level - 1, 2 * index + 1,
+                         badBlocks, maxBad, found);
+
+    return found;
+}
+
+static void putLE32(uint8_t *out, uint32_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+    out[2] = value >> 16;
+    out[3] = value >> 24;
+}
+
+static uint32_t getLE32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) |
+           ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+uint32_t crc32_tree_init(crc32_tree *tree, uint32_t *nodes, uint32_t length, uint32_t blockSize)
+{
+    uint32_t offsets[CRC32_TREE_MAX_LEVELS], counts[CRC32_TREE_MAX_LEVELS];
+    uint32_t levels;
+
+    tree->length = length;
+    tree->blockSize = blockSize;
+    tree->leafCount = (length + blockSize - 1) / blockSize;
+    tree->nodes = nodes;
+
+    levels = levelOffsets(tree, offsets, counts);
+    tree->nodeCount = levels ? offsets[levels - 1] + 1 : 0;
+
+    return tree->nodeCount;
+}
+
+void crc32_tree_build(crc32_tree *tree, const uint8_t *data)
+{
+    uint32_t offsets[CRC32_TREE_MAX_LEVELS], counts[CRC32_TREE_MAX_LEVELS];
+    uint32_t levels = levelOffsets(tree, offsets, counts);
+    uint32_t level, ii;
+
+    for (ii = 0; ii < tree->leafCount; ii++)
+        tree->nodes[ii] = calculateCRC32((uint8_t*)data + ii * tree->blockSize,
+                                         nodeLength(tree, 0, ii));
+
+    for (level = 1; level < levels; level++)
+        for (ii = 0; ii < counts[level]; ii++)
+            combineNode(tree, offsets, counts, level, ii);
+}
+
+void crc32_tree_update_block(crc32_tree *tree, const uint8_t *data, uint32_t block)
+{
+    uint32_t offsets[CRC32_TREE_MAX_LEVELS], counts[CRC32_TREE_MAX_LEVELS];
+    uint32_t levels = levelOffsets(tree, offsets, counts);
+    uint32_t level;
+
+    if (block >= tree->leafCount)
+        return;
+
+    tree->nodes[block] = calculateCRC32((uint8_t*)data + block * tree->blockSize,
+                                        nodeLength(tree, 0, block));
+
+    for (level = 1; level < levels; level++)
+    {
+        block /= 2;
+        combineNode(tree, offsets, counts, level, block);
+    }
+}
+
+uint32_t crc32_tree_root(const crc32_tree *tree)
+{
+    return tree->nodeCount ? tree->nodes[tree->nodeCount - 1] : 0;
+}
+
+uint32_t crc32_tree_diff(const crc32_tree *tree, const crc32_tree *reference,
+                         uint32_t *badBlocks, uint32_t maxBad)
+{
+    uint32_t offsets[CRC32_TREE_MAX_LEVELS], counts[CRC32_TREE_MAX_LEVELS];
+    uint32_t levels = levelOffsets(tree, offsets, counts);
+    uint32_t ii;
+
+    /* Different geometry: nothing can be matched, every block is suspect */
+    if (tree->length != reference->length || tree->blockSize != reference->blockSize)
+    {
+        for (ii = 0; ii < tree->leafCount && ii < maxBad; ii++)
+            badBlocks[ii] = ii;
+        return tree->leafCount;
+    }
+
+    if (levels == 0)
+        return 0;
+
+    return diffNode(tree, reference, offsets, counts, levels - 1, 0, badBlocks, maxBad, 0);
+}
+
+uint32_t crc32_tree_serialize(const crc32_tree *tree, uint8_t *out, uint32_t size)
+{
+    uint32_t total = CRC32_TREE_HEADER_SIZE + 4 * tree->nodeCount;
+    uint32_t ii;
+
+    if (size < total)
+        return 0;
+
+    putLE32(out, CRC32_TREE_MAGIC);
+    putLE32(out + 4, tree->length);
+    putLE32(out + 8, tree->blockSize);
+    putLE32(out + 12, tree->nodeCount);
+
+    for (ii = 0; ii < tree->nodeCount; ii++)
+        putLE32(out + CRC32_TREE_HEADER_SIZE + 4 * ii, tree->nodes[ii]);
+
+    return total;
+}
+
+bool crc32_tree_deserialize(crc32_tree *tree, uint32_t *nodes, uint32_t maxNodes,
+                            const uint8_t *in, uint32_t size)
+{
+    uint32_t length, blockSize, nodeCount, ii;
+
+    if (size < CRC32_TREE_HEADER_SIZE || getLE32(in) != CRC32_TREE_MAGIC)
+        return false;
+
+    length = getLE32(in + 4);
+    blockSize = getLE32(in + 8);
+    nodeCount = getLE32(in + 12);
+
+    if (blockSize == 0 || nodeCount > maxNodes ||
+        size < CRC32_TREE_HEADER_SIZE + 4 * nodeCount)
+        return false;
+
+    if (crc32_tree_init(tree, nodes, length, blockSize) != nodeCount)
+        return false;
+
+    for (ii = 0; ii < nodeCount; ii++)
+        nodes[ii] = getLE32(in + CRC32_TREE_HEADER_SIZE + 4 * ii);
+
+    return true;
+}
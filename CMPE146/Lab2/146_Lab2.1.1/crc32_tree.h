@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * CRC32 block tree
+ *
+ * Splits a buffer into fixed-size blocks, keeps the CRC32 of every block as a
+ * leaf and builds parent nodes with crc32_combine(), so the root is the CRC32
+ * of the whole buffer. Two trees of the same geometry, e.g. one built on the
+ * device and a reference tree shipped with the image, are compared top-down:
+ * crc32_tree_diff() only descends into mismatching subtrees, so locating a
+ * single bad block takes O(log n) node comparisons instead of comparing every
+ * leaf. After a block has been rewritten, crc32_tree_update_block() refreshes
+ * the tree with one block hash and O(log n) combines instead of a rescan.
+ *
+ * Node storage is supplied by the caller (no heap); CRC32_TREE_MAX_NODES()
+ * gives a safe size. Builds for the host as well.
+ ******************************************************************************/
+#ifndef CRC32_TREE_H_
+#define CRC32_TREE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Upper bound on the nodes of a tree with the given number of leaves */
+#define CRC32_TREE_MAX_NODES(leaves)    (2 * (leaves) + 32)
+
+/* Serialized size: 16-byte header plus 4 bytes per node */
+#define CRC32_TREE_HEADER_SIZE          16
+#define CRC32_TREE_MAGIC                0x54435243      /* "CRCT" */
+
+typedef struct
+{
+    uint32_t length;            /* bytes covered */
+    uint32_t blockSize;         /* bytes per leaf, the last leaf may be short */
+    uint32_t leafCount;
+    uint32_t nodeCount;
+    uint32_t *nodes;            /* levels bottom-up: leaves first, root last */
+} crc32_tree;
+
+/* Set up the geometry; nodes must hold CRC32_TREE_MAX_NODES(leaves) entries.
+ * Returns the number of nodes used. */
+uint32_t crc32_tree_init(crc32_tree *tree, uint32_t *nodes, uint32_t length, uint32_t blockSize);
+
+/* Hash every block of data and build the tree */
+void crc32_tree_build(crc32_tree *tree, const uint8_t *data);
+
+/* Rehash one block and update its ancestors */
+void crc32_tree_update_block(crc32_tree *tree, const uint8_t *data, uint32_t block);
+
+/* CRC32 of the whole buffer */
+uint32_t crc32_tree_root(const crc32_tree *tree);
+
+/* Compare against a reference tree of the same geometry. Writes up to
+ * maxBad indices of mismatching blocks to badBlocks and returns how many
+ * blocks mismatch in total (0 if the trees agree). */
+uint32_t crc32_tree_diff(const crc32_tree *tree, const crc32_tree *reference,
+                         uint32_t *badBlocks, uint32_t maxBad);
+
+/* Little-endian serialization; returns bytes written, 0 if out is too small */
+uint32_t crc32_tree_serialize(const crc32_tree *tree, uint8_t *out, uint32_t size);
+
+/* Load a serialized tree into caller storage of maxNodes entries */
+bool crc32_tree_deserialize(crc32_tree *tree, uint32_t *nodes, uint32_t maxNodes,
+                            const uint8_t *in, uint32_t size);
+
+#endif /* CRC32_TREE_H_ */
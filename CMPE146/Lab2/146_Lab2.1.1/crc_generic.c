@@ -0,0 +1,225 @@
+/*******************************************************************************
+ * Parameterized CRC engine
+ *
+ * Kernel tables are generated by the preprocessor the same way as the CRC32
+ * tables in crc32_tables.h: every entry is the XOR of the single-bit entries
+ * for the bits set in its index, and the single-bit entries are the first
+ * eight points of one shift chain kept as enumeration constants (16-bit
+ * halves, so any width up to 32 bits fits). A reflected CRC shifts right from
+ * 1 and uses x(8-i) for bit i; an MSB-first CRC shifts left from its top bit
+ * and uses x(i+1). Each preset below instantiates its own chain and table.
+ ******************************************************************************/
+#include "crc_generic.h"
+
+#if defined(__MSP432P401R__)
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "crc32_hw.h"
+#include "crc32_arbiter.h"
+#endif
+
+/* Preset parameters, p##_WIDTH etc. are looked up by the table macros */
+#define CRC_SMBUS8_WIDTH        8
+#define CRC_SMBUS8_POLY         0x07u
+#define CRC_SMBUS8_REFIN        0
+
+#define CRC_CCITT16_WIDTH       16
+#define CRC_CCITT16_POLY        0x1021u
+#define CRC_CCITT16_REFIN       0
+
+#define CRC_HDLC32_WIDTH        32
+#define CRC_HDLC32_POLY         0x04C11DB7u
+#define CRC_HDLC32_REFIN        1
+
+#define CRC_CASTAGNOLI32_WIDTH  32
+#define CRC_CASTAGNOLI32_POLY   0x1EDC6F41u
+#define CRC_CASTAGNOLI32_REFIN  1
+
+/* Compile-time bit reversal of a 32-bit constant */
+#define CRC_SWAP(v, s, m)       ((((v) >> (s)) & (m)) | (((v) & (m)) << (s)))
+#define CRC_REV32(v)            CRC_SWAP(CRC_SWAP(CRC_SWAP(CRC_SWAP(CRC_SWAP(v, \
+                                    1, 0x55555555u), 2, 0x33333333u), \
+                                    4, 0x0F0F0F0Fu), 8, 0x00FF00FFu), 16, 0x0000FFFFu)
+
+/* Register masks and top bit, split into 16-bit halves */
+#define CRC_W(p)                (p##_WIDTH)
+#define CRC_MASK_HI(p)          (CRC_W(p) > 16 ? 0xFFFFu >> (32 - (CRC_W(p) > 16 ? CRC_W(p) : 32)) : 0)
+#define CRC_MASK_LO(p)          (0xFFFFu >> (16 - (CRC_W(p) >= 16 ? 16 : CRC_W(p))))
+#define CRC_TOP(p, h, l)        (CRC_W(p) > 16 ? ((h) >> (CRC_W(p) > 16 ? CRC_W(p) - 17 : 0)) & 1 \
+                                               : ((l) >> (CRC_W(p) > 16 ? 0 : CRC_W(p) - 1)) & 1)
+
+/* One register shift, reflected (right) or MSB-first (left) */
+#define CRC_STEP_HI(p, h, l)    (p##_REFIN ? \
+    (((h) >> 1) ^ (((l) & 1) ? (uint32_t)p##_RH : 0)) : \
+    (((((h) << 1) | ((l) >> 15)) & CRC_MASK_HI(p)) ^ (CRC_TOP(p, h, l) ? (p##_POLY >> 16) : 0)))
+#define CRC_STEP_LO(p, h, l)    (p##_REFIN ? \
+    ((((l) >> 1) | (((h) & 1) << 15)) ^ (((l) & 1) ? (uint32_t)p##_RL : 0)) : \
+    ((((l) << 1) & CRC_MASK_LO(p)) ^ (CRC_TOP(p, h, l) ? (p##_POLY & 0xFFFF) : 0)))
+
+#define CRC_LINK(p, n, m)       p##_H##n = CRC_STEP_HI(p, p##_H##m, p##_L##m), \
+                                p##_L##n = CRC_STEP_LO(p, p##_H##m, p##_L##m)
+
+#define CRC_CHAIN(p) \
+    enum \
+    { \
+        p##_RH = (CRC_REV32(p##_POLY) >> (32 - CRC_W(p))) >> 16, \
+        p##_RL = (CRC_REV32(p##_POLY) >> (32 - CRC_W(p))) & 0xFFFF, \
+        p##_H0 = p##_REFIN ? 0 : (CRC_W(p) > 16 ? 1u << (CRC_W(p) > 16 ? CRC_W(p) - 17 : 0) : 0), \
+        p##_L0 = p##_REFIN ? 1 : (CRC_W(p) > 16 ? 0 : 1u << (CRC_W(p) > 16 ? 0 : CRC_W(p) - 1)), \
+        CRC_LINK(p, 1, 0), CRC_LINK(p, 2, 1), CRC_LINK(p, 3, 2), CRC_LINK(p, 4, 3), \
+        CRC_LINK(p, 5, 4), CRC_LINK(p, 6, 5), CRC_LINK(p, 7, 6), CRC_LINK(p, 8, 7) \
+    }
+
+#define CRC_X(p, m)             (((uint32_t)p##_H##m << 16) | (uint32_t)p##_L##m)
+#define CRC_BIT(n, i, x)        ((((n) >> (i)) & 1) ? (x) : 0)
+#define CRC_ENTRY(p, n, a, b, c, d, e, f, g, h) \
+    (CRC_BIT(n, 0, CRC_X(p, a)) ^ CRC_BIT(n, 1, CRC_X(p, b)) ^ \
+     CRC_BIT(n, 2, CRC_X(p, c)) ^ CRC_BIT(n, 3, CRC_X(p, d)) ^ \
+     CRC_BIT(n, 4, CRC_X(p, e)) ^ CRC_BIT(n, 5, CRC_X(p, f)) ^ \
+     CRC_BIT(n, 6, CRC_X(p, g)) ^ CRC_BIT(n, 7, CRC_X(p, h)))
+#define CRC_T(p, n)             (p##_REFIN ? CRC_ENTRY(p, n, 8, 7, 6, 5, 4, 3, 2, 1) \
+                                           : CRC_ENTRY(p, n, 1, 2, 3, 4, 5, 6, 7, 8))
+
+#define CRC_ROW4(p, n)          CRC_T(p, n), CRC_T(p, (n) + 1), CRC_T(p, (n) + 2), CRC_T(p, (n) + 3)
+#define CRC_ROW16(p, n)         CRC_ROW4(p, n), CRC_ROW4(p, (n) + 4), \
+                                CRC_ROW4(p, (n) + 8), CRC_ROW4(p, (n) + 12)
+#define CRC_ROW64(p, n)         CRC_ROW16(p, n), CRC_ROW16(p, (n) + 16), \
+                                CRC_ROW16(p, (n) + 32), CRC_ROW16(p, (n) + 48)
+#define CRC_TABLE(p)            { CRC_ROW64(p, 0), CRC_ROW64(p, 64), \
+                                  CRC_ROW64(p, 128), CRC_ROW64(p, 192) }
+
+CRC_CHAIN(CRC_SMBUS8);
+CRC_CHAIN(CRC_CCITT16);
+CRC_CHAIN(CRC_HDLC32);
+CRC_CHAIN(CRC_CASTAGNOLI32);
+
+static const uint32_t crc8Table[256] = CRC_TABLE(CRC_SMBUS8);
+static const uint32_t crc16CcittTable[256] = CRC_TABLE(CRC_CCITT16);
+static const uint32_t crc32HdlcTable[256] = CRC_TABLE(CRC_HDLC32);
+static const uint32_t crc32cTable[256] = CRC_TABLE(CRC_CASTAGNOLI32);
+
+const crc_params crc8Params =
+    { 8, 0x07, false, false, 0x00, 0x00, crc8Table };
+const crc_params crc16CcittParams =
+    { 16, 0x1021, false, false, 0xFFFF, 0x0000, crc16CcittTable };
+const crc_params crc32Params =
+    { 32, 0x04C11DB7, true, true, 0xFFFFFFFF, 0xFFFFFFFF, crc32HdlcTable };
+const crc_params crc32cParams =
+    { 32, 0x1EDC6F41, true, true, 0xFFFFFFFF, 0xFFFFFFFF, crc32cTable };
+
+static uint32_t crc_mask(const crc_params *params)
+{
+    return 0xFFFFFFFF >> (32 - params->width);
+}
+
+static uint32_t crc_reflect(uint32_t value, uint8_t width)
+{
+    uint32_t result = 0;
+    uint8_t ii;
+
+    for (ii = 0; ii < width; ii++)
+    {
+        result = (result << 1) | (value & 1);
+        value >>= 1;
+    }
+
+    return result;
+}
+
+uint32_t crc_init(const crc_params *params)
+{
+    return params->refin ? crc_reflect(params->init, params->width) : params->init;
+}
+
+uint32_t crc_update(const crc_params *params, uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    const uint32_t *table = params->table;
+    uint32_t mask = crc_mask(params);
+    uint8_t shift = params->width - 8;
+    uint32_t ii, jj;
+
+    if (params->refin)
+    {
+        uint32_t poly = crc_reflect(params->poly, params->width);
+
+        if (table)
+        {
+            for (ii = 0; ii < length; ii++)
+                crc = (crc >> 8) ^ table[(crc ^ data[ii]) & 0xFF];
+        }
+        else
+        {
+            for (ii = 0; ii < length; ii++)
+            {
+                crc ^= data[ii];
+                for (jj = 0; jj < 8; jj++)
+                    crc = (crc >> 1) ^ (poly & -(crc & 1));
+            }
+        }
+    }
+    else
+    {
+        uint32_t top = (uint32_t)1 << (params->width - 1);
+
+        if (table)
+        {
+            for (ii = 0; ii < length; ii++)
+                crc = ((crc << 8) & mask) ^ table[((crc >> shift) ^ data[ii]) & 0xFF];
+        }
+        else
+        {
+            for (ii = 0; ii < length; ii++)
+            {
+                crc ^= (uint32_t)data[ii] << shift;
+                for (jj = 0; jj < 8; jj++)
+                    crc = ((crc << 1) & mask) ^ ((crc & top) ? params->poly : 0);
+            }
+        }
+    }
+
+    return crc;
+}
+
+uint32_t crc_final(const crc_params *params, uint32_t crc)
+{
+    if (params->refin != params->refout)
+        crc = crc_reflect(crc, params->width);
+
+    return (crc ^ params->xorout) & crc_mask(params);
+}
+
+bool crc_hw_supported(const crc_params *params)
+{
+#if defined(__MSP432P401R__)
+    if (params->refin != params->refout)
+        return false;
+
+    return (params->width == 16 && params->poly == 0x1021) ||
+           (params->width == 32 && params->poly == 0x04C11DB7);
+#else
+    (void)params;
+    return false;
+#endif
+}
+
+uint32_t crc_calculate(const crc_params *params, const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = crc_init(params);
+
+#if defined(__MSP432P401R__)
+    static const char client = 0;
+
+    /* The module reseeds, so only while nobody else has it; otherwise the
+     * table kernel computes the same value */
+    if (crc_hw_supported(params) && crc32_arbiter_acquire(&client))
+    {
+        crc = crc32_hw_calculate(params->width == 16 ? CRC16_MODE : CRC32_MODE,
+                                 params->refin, crc, data, length);
+        crc32_arbiter_release(&client);
+        return crc_final(params, crc);
+    }
+#endif
+
+    return crc_final(params, crc_update(params, crc, data, length));
+}
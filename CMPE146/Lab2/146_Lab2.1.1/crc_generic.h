@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Parameterized CRC engine
+ *
+ * CRCs of 8 to 32 bits described by the usual model parameters: width,
+ * polynomial (normal, MSB-first form), input/output reflection, initial
+ * register value and final XOR. Each preset carries a 256-entry table that is
+ * generated at build time for its polynomial and direction and lives in
+ * flash (see crc_generic.c); parameter sets without a table run bitwise.
+ *
+ * On the MSP432, crc_calculate() routes to the CRC32 module whenever it can
+ * compute the variant: polynomial 0x1021 in CRC16_MODE and 0x04C11DB7 in
+ * CRC32_MODE, for reflected (refin == refout == true) as well as MSB-first
+ * (refin == refout == false) variants. The module is claimed through
+ * crc32_arbiter.h; if another client owns it, the table kernel runs
+ * instead. Everything else, like CRC-8 and CRC-32C, uses the table kernel.
+ *
+ * Builds for the host as well, where everything runs in software.
+ ******************************************************************************/
+#ifndef CRC_GENERIC_H_
+#define CRC_GENERIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    uint8_t width;              /* register width in bits, 8..32 */
+    uint32_t poly;              /* generator polynomial, normal form */
+    bool refin;                 /* process input bytes LSB first */
+    bool refout;                /* reflect the register before xorout */
+    uint32_t init;              /* initial register value */
+    uint32_t xorout;            /* XORed into the final value */
+    const uint32_t *table;      /* 256-entry kernel table, NULL for bitwise */
+} crc_params;
+
+/* Presets; check value is the CRC of the ASCII string "123456789" */
+extern const crc_params crc8Params;         /* CRC-8/SMBUS,        check 0xF4 */
+extern const crc_params crc16CcittParams;   /* CRC-16/CCITT-FALSE, check 0x29B1 */
+extern const crc_params crc32Params;        /* CRC-32/ISO-HDLC,    check 0xCBF43926 */
+extern const crc_params crc32cParams;       /* CRC-32C/Castagnoli, check 0xE3069283 */
+
+/* Streaming use: crc_init(), any number of crc_update() calls, crc_final().
+ * The intermediate value is the raw register and always runs in software. */
+uint32_t crc_init(const crc_params *params);
+uint32_t crc_update(const crc_params *params, uint32_t crc, const uint8_t *data, uint32_t length);
+uint32_t crc_final(const crc_params *params, uint32_t crc);
+
+/* Whole-buffer CRC, on the CRC32 module when it supports the variant */
+uint32_t crc_calculate(const crc_params *params, const uint8_t *data, uint32_t length);
+
+/* True if crc_calculate() runs this parameter set on the CRC32 module when
+ * the module is free */
+bool crc_hw_supported(const crc_params *params);
+
+#endif /* CRC_GENERIC_H_ */
@@ -59,6 +59,11 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "block_cache.h"
+#include "dma_manager.h"
+#include "dma_mem.h"
+#include "aes_dma.h"
+
 /* Statics */
 static uint8_t Data[16] =
 { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc,
@@ -70,6 +75,23 @@ static uint8_t CipherKey[32] =
 static uint8_t DataAESencrypted[1600];       // Encrypted data
 static uint8_t DataAESdecrypted[1600];       // Decrypted data
 
+/* DMA clients and their channels */
+static const dma_client dmaClients[] = {
+    {"memcpy", DMA_CH7_RESERVED0, false, false, dma_mem_interrupt},
+    {"AES256 out", DMA_CH0_AESTRIGGER0, true, false, aes_dma_interrupt},
+    {"AES256 in", DMA_CH1_AESTRIGGER1, true, false, NULL},
+};
+
+/* Bulk AES256 benchmark buffers */
+static uint8_t bulkPlain[16384];
+static uint8_t bulkCipher[16384];
+static const uint32_t bulkSizes[] = {1024, 4096, 16384};
+
+/* Buffer re-encrypted through the block cache, one generation per block */
+static uint8_t data_array[1024];
+static uint32_t dataGenerations[sizeof(data_array) / BLOCK_CACHE_BLOCK_SIZE];
+static uint32_t dataCRCs[sizeof(data_array) / BLOCK_CACHE_BLOCK_SIZE];
+
 void encrypt_message(char* str, uint8_t* encrypted, uint8_t* key) {
     /* Load a cipher key to module */
     MAP_AES256_setCipherKey(AES256_BASE, key, AES256_KEYLENGTH_256BIT);
@@ -80,25 +102,15 @@ void encrypt_message(char* str, uint8_t* encrypted, uint8_t* key) {
     int i;
     for (i = 0; i < numberOfGroups; i++) {
         int startIndex = 16 * i;
-        int endIndex = startIndex + 16;
 
         static uint8_t tempData[16];
-        int k = 0;
-        int j;
-        for (j = startIndex; j < endIndex; j++) {
-            tempData[k] = (uint8_t)(str[j]);
-            k++;
-        }
+        dma_memcpy(tempData, &str[startIndex], 16);
 
         static uint8_t tempEncrypted[16];
         /* Encrypt data with preloaded cipher key */
         MAP_AES256_encryptData(AES256_BASE, tempData, tempEncrypted);
 
-        k = 0;
-        for (j = startIndex; j < endIndex; j++) {
-            DataAESencrypted[j] = tempEncrypted[k];
-            k++;
-        }
+        dma_memcpy(&DataAESencrypted[startIndex], tempEncrypted, 16);
     }
 }
 
@@ -111,25 +123,25 @@ void decrypt_message(uint8_t* data, int data_length, uint8_t* decrypted, uint8_t
     int i;
     for (i = 0; i < numberOfGroups; i++) {
         int startIndex = 16 * i;
-        int endIndex = startIndex + 16;
 
         static uint8_t tempData[16];
-        int k = 0;
-        int j;
-        for (j = startIndex; j < endIndex; j++) {
-            tempData[k] = data[j];
-            k++;
-        }
+        dma_memcpy(tempData, &data[startIndex], 16);
 
         static uint8_t tempDecrypted[16];
         /* Decrypt data with keys that were generated during encryption*/
         MAP_AES256_decryptData(AES256_BASE, tempData, tempDecrypted);
 
-        k = 0;
-        for (j = startIndex; j < endIndex; j++) {
-            DataAESdecrypted[j] = tempDecrypted[k];
-            k++;
-        }
+        dma_memcpy(&DataAESdecrypted[startIndex], tempDecrypted, 16);
+    }
+}
+
+/* The per-block loop of encrypt_message() over a raw buffer */
+void cpu_encrypt_blocks(const uint8_t* in, uint8_t* out, uint32_t blocks, uint8_t* key) {
+    MAP_AES256_setCipherKey(AES256_BASE, key, AES256_KEYLENGTH_256BIT);
+
+    uint32_t i;
+    for (i = 0; i < blocks; i++) {
+        MAP_AES256_encryptData(AES256_BASE, &in[16 * i], &out[16 * i]);
     }
 }
 
@@ -140,6 +152,27 @@ int main(void) {
     int i;
     char* message = "How much wood could a wood chuck chuck if a wood chuck could chuck wood?";
 
+    /* Configuring DMA module: one entry per DMA client */
+    uint32_t failedClient;
+    if (dma_manager_init(dmaClients, sizeof(dmaClients)/sizeof(dmaClients[0]),
+                         &failedClient) != DMA_MANAGER_OK) {
+        printf("\nDMA channel conflict: %s\n", dmaClients[failedClient].name);
+        while (1);
+    }
+    MAP_Interrupt_enableMaster();
+
+    /* Measure where DMA starts beating the CPU, then clear the buffers */
+    dma_mem_crossover crossover;
+    dma_mem_calibrate(DataAESdecrypted, DataAESencrypted, sizeof(DataAESencrypted));
+    dma_mem_get(&crossover);
+    printf("\nDMA memcpy from %u bytes, memset from %u bytes", crossover.copyMin, crossover.setMin);
+
+    /* Count only the real transfers, not the calibration runs */
+    dma_manager_reset_counters();
+
+    dma_memset(DataAESencrypted, 0, sizeof(DataAESencrypted));
+    dma_memset(DataAESdecrypted, 0, sizeof(DataAESdecrypted));
+
     encrypt_message(message, DataAESencrypted, CipherKey);
 
     decrypt_message(DataAESencrypted, strlen(message), DataAESdecrypted, CipherKey);
@@ -158,4 +191,70 @@ int main(void) {
     for (i = 0; i < strlen(message); i++) {
         printf("%c", (char)(DataAESdecrypted[i]));
     }
+
+    /* Re-encrypt a mostly unchanged buffer: only written blocks miss */
+    for (i = 0; i < sizeof(data_array); i++) {
+        data_array[i] = message[i % strlen(message)];
+    }
+
+    block_cache_init(CipherKey);
+    block_cache_process_buffer(data_array, sizeof(data_array), dataGenerations, dataCRCs,
+                               DataAESencrypted);
+
+    data_array[100] ^= 0x20;
+    dataGenerations[100 / BLOCK_CACHE_BLOCK_SIZE]++;
+
+    /* Snapshot the plaintext by DMA while the cache re-encrypts it */
+    dma_memcpy_async(DataAESdecrypted, data_array, sizeof(data_array));
+
+    uint32_t hits = block_cache_process_buffer(data_array, sizeof(data_array), dataGenerations,
+                                               dataCRCs, DataAESencrypted);
+
+    dma_mem_wait();
+    printf("\n\nPlaintext snapshot: %s",
+           memcmp(DataAESdecrypted, data_array, sizeof(data_array)) == 0 ? "match" : "MISMATCH");
+    const block_cache_stats *stats = block_cache_get_stats();
+
+    printf("\n\nBlock cache: %u of %u blocks reused (%u hits, %u misses in total)",
+           hits, sizeof(dataGenerations) / sizeof(dataGenerations[0]), stats->hits, stats->misses);
+
+    /* Bulk AES256: per-block CPU loop against two DMA channels */
+    for (i = 0; i < sizeof(bulkPlain); i++) {
+        bulkPlain[i] = i * 7 + (i >> 8);
+    }
+
+    for (i = 0; i < sizeof(bulkSizes)/sizeof(bulkSizes[0]); i++) {
+        uint32_t length = bulkSizes[i];
+        uint32_t blocks = length / 16;
+        uint32_t j;
+
+        uint32_t cpu_t0 = DWT->CYCCNT;
+        cpu_encrypt_blocks(bulkPlain, bulkCipher, blocks, CipherKey);
+        uint32_t cpuCycles = DWT->CYCCNT - cpu_t0;
+
+        /* In place, then compared with the CPU ciphertext. Spin rather
+         * than sleep: the cycle counter stops in LPM0. */
+        uint32_t dma_t0 = DWT->CYCCNT;
+        aes_dma_encrypt_async(CipherKey, bulkPlain, bulkPlain, blocks);
+        while (aes_dma_busy());
+        uint32_t dmaCycles = DWT->CYCCNT - dma_t0;
+
+        bool encryptOk = memcmp(bulkPlain, bulkCipher, length) == 0;
+
+        aes_dma_decrypt(CipherKey, bulkPlain, bulkPlain, blocks);
+
+        bool decryptOk = true;
+        for (j = 0; j < length; j++) {
+            decryptOk = decryptOk && bulkPlain[j] == (uint8_t)(j * 7 + (j >> 8));
+        }
+
+        printf("\n\nBulk AES256 %u bytes: CPU %u cycles, DMA %u cycles (%f times faster)",
+               length, cpuCycles, dmaCycles, (float)cpuCycles/(float)dmaCycles);
+        printf("\nDMA ciphertext %s, round trip %s", encryptOk ? "match" : "MISMATCH",
+               decryptOk ? "match" : "MISMATCH");
+    }
+
+    /* Per-channel DMA counters and the last DMA events, in SysTick ticks */
+    printf("\n\n");
+    dma_manager_dump();
 }
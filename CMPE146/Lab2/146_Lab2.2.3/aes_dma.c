@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Bulk AES256 over DMA
+ *
+ * Per pass: both channels are armed in basic mode for blocks * 8 halfwords
+ * with an arbitration size of 8, so every trigger moves exactly one block,
+ * then writing AESBLKCNT starts the module. The completion interrupt of the
+ * output channel arms the next pass; after the last one AESCMEN is cleared
+ * again so the per-block driverlib calls keep working.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "aes_dma.h"
+#include "dma_manager.h"
+
+static const uint8_t *aesIn;
+static uint8_t *aesOut;
+static uint32_t aesRemaining;           /* blocks not yet started */
+static uint32_t aesPass;                /* blocks in the running pass */
+static volatile bool aesBusy;
+
+static void startPass(void)
+{
+    aesPass = aesRemaining > AES_DMA_PASS_BLOCKS ? AES_DMA_PASS_BLOCKS : aesRemaining;
+
+    MAP_DMA_setChannelTransfer(AES_DMA_IN_CHANNEL | UDMA_PRI_SELECT,
+                               UDMA_MODE_BASIC,
+                               (void*) aesIn,
+                               (void*) &AES256->DIN,
+                               aesPass * 8);
+    dma_manager_transfer(AES_DMA_IN_CHANNEL, aesPass * 8, UDMA_ARB_8);
+    MAP_DMA_setChannelTransfer(AES_DMA_OUT_CHANNEL | UDMA_PRI_SELECT,
+                               UDMA_MODE_BASIC,
+                               (void*) &AES256->DOUT,
+                               (void*) aesOut,
+                               aesPass * 8);
+    dma_manager_transfer(AES_DMA_OUT_CHANNEL, aesPass * 8, UDMA_ARB_8);
+
+    MAP_DMA_enableChannel(AES_DMA_IN_CHANNEL);
+    MAP_DMA_enableChannel(AES_DMA_OUT_CHANNEL);
+
+    aesIn += aesPass * 16;
+    aesOut += aesPass * 16;
+    aesRemaining -= aesPass;
+
+    /* Writing the block count starts the module and its triggers */
+    AES256->CTL1 = aesPass;
+}
+
+static void start(const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    aes_dma_wait();
+
+    if (blocks == 0)
+        return;
+
+    MAP_DMA_setChannelControl(AES_DMA_IN_CHANNEL | UDMA_PRI_SELECT,
+                              UDMA_SIZE_16 | UDMA_SRC_INC_16 | UDMA_DST_INC_NONE | UDMA_ARB_8);
+    MAP_DMA_setChannelControl(AES_DMA_OUT_CHANNEL | UDMA_PRI_SELECT,
+                              UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_8);
+
+    /* ECB cipher mode, keeping the operation the key load selected */
+    AES256->CTL0 = (AES256->CTL0 & ~AES256_CTL0_CM_MASK) | AES256_CTL0_CM_0 | AES256_CTL0_CMEN;
+
+    aesIn = in;
+    aesOut = out;
+    aesRemaining = blocks;
+    aesBusy = true;
+
+    dma_manager_job_start(AES_DMA_IN_CHANNEL);
+    dma_manager_job_start(AES_DMA_OUT_CHANNEL);
+    startPass();
+}
+
+void aes_dma_encrypt_async(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    aes_dma_wait();
+    MAP_AES256_setCipherKey(AES256_BASE, key, AES256_KEYLENGTH_256BIT);
+    start(in, out, blocks);
+}
+
+void aes_dma_decrypt_async(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    aes_dma_wait();
+    MAP_AES256_setDecipherKey(AES256_BASE, key, AES256_KEYLENGTH_256BIT);
+    start(in, out, blocks);
+}
+
+bool aes_dma_busy(void)
+{
+    return aesBusy;
+}
+
+void aes_dma_wait(void)
+{
+    /* Check and sleep with interrupts masked: WFI still wakes on the pending
+     * DMA interrupt, so a completion between the two cannot be missed */
+    bool wasMasked = MAP_Interrupt_disableMaster();
+
+    while (aesBusy)
+    {
+        MAP_PCM_gotoLPM0();
+        MAP_Interrupt_enableMaster();
+        MAP_Interrupt_disableMaster();
+    }
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+void aes_dma_encrypt(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    aes_dma_encrypt_async(key, in, out, blocks);
+    aes_dma_wait();
+}
+
+void aes_dma_decrypt(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks)
+{
+    aes_dma_decrypt_async(key, in, out, blocks);
+    aes_dma_wait();
+}
+
+void aes_dma_interrupt(void)
+{
+    if (aesRemaining > 0)
+    {
+        startPass();
+        return;
+    }
+
+    AES256->CTL0 &= ~AES256_CTL0_CMEN;
+    aesBusy = false;
+    dma_manager_job_done(AES_DMA_IN_CHANNEL);
+    dma_manager_job_done(AES_DMA_OUT_CHANNEL);
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Bulk AES256 over DMA
+ *
+ * Encrypts or decrypts N 16-byte blocks in ECB mode with the AES256 module in
+ * cipher mode (AESCMEN): the module raises AES trigger 0 whenever a result is
+ * ready and trigger 1 whenever it can take a block. DMA channel 0 answers
+ * trigger 0 with eight 16-bit reads of AESADOUT into the output, channel 1
+ * answers trigger 1 with eight 16-bit writes of plaintext to AESADIN, so the
+ * CPU never touches the data. Completion is one interrupt on channel 0 per
+ * pass of up to AES_DMA_PASS_BLOCKS blocks, the most one DMA cycle of 1024
+ * halfwords can carry; the output channel finishes last.
+ *
+ * Output may equal input, but must not overlap it otherwise. The result of a
+ * block only exists once the block has been written to the module, so
+ * out[i] is never written before in[i] is read, whichever channel the uDMA
+ * serves first. When both triggers are pending, channel 0 wins (same
+ * priority, lower number), so a result is drained before the next block is
+ * fetched and the write never runs ahead of the read by more than one block.
+ * The ciphertext is the same as encrypt_message() produces block by block.
+ *
+ * Register both channels with dma_manager_init(): DMA_CH0_AESTRIGGER0 with
+ * aes_dma_interrupt() and DMA_CH1_AESTRIGGER1 without a handler.
+ ******************************************************************************/
+#ifndef AES_DMA_H_
+#define AES_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AES_DMA_OUT_CHANNEL     0
+#define AES_DMA_IN_CHANNEL      1
+#define AES_DMA_PASS_BLOCKS     128
+
+/* Start a bulk transfer with a 256-bit key; returns at once */
+void aes_dma_encrypt_async(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks);
+void aes_dma_decrypt_async(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks);
+
+bool aes_dma_busy(void);
+
+/* Sleep in LPM0 until the last block is written */
+void aes_dma_wait(void);
+
+/* Blocking versions */
+void aes_dma_encrypt(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks);
+void aes_dma_decrypt(const uint8_t *key, const uint8_t *in, uint8_t *out, uint32_t blocks);
+
+/* Completion handler for the DMA manager (output channel) */
+void aes_dma_interrupt(void);
+
+#endif /* AES_DMA_H_ */
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * CRC32/AES256 block cache
+ *
+ * With 16 entries a linear scan is cheaper than any index. Recency is a
+ * global use counter stamped into the entry on every hit or fill; the entry
+ * with the smallest stamp (or a free one) is the victim.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include <string.h>
+
+#include "block_cache.h"
+
+typedef struct
+{
+    const uint8_t *address;     /* NULL: free */
+    uint32_t length;
+    uint32_t generation;
+    uint32_t lastUse;
+    uint32_t crc;
+    uint8_t encrypted[BLOCK_CACHE_BLOCK_SIZE];
+} block_cache_entry;
+
+static block_cache_entry entries[BLOCK_CACHE_ENTRIES];
+static uint8_t cipherKey[32];
+static uint32_t useCounter;
+static block_cache_stats stats;
+
+static uint32_t crcBlock(const uint8_t *data, uint32_t length)
+{
+    uint32_t ii;
+
+    MAP_CRC32_setSeed(0xFFFFFFFF, CRC32_MODE);
+
+    for (ii = 0; ii < length; ii++)
+        MAP_CRC32_set8BitData(data[ii], CRC32_MODE);
+
+    return MAP_CRC32_getResultReversed(CRC32_MODE) ^ 0xFFFFFFFF;
+}
+
+static void encryptBlock(const uint8_t *data, uint32_t length, uint8_t *encrypted)
+{
+    uint8_t plain[16];
+    uint32_t offset;
+
+    MAP_AES256_setCipherKey(AES256_BASE, cipherKey, AES256_KEYLENGTH_256BIT);
+
+    for (offset = 0; offset < length; offset += 16)
+    {
+        uint32_t chunk = length - offset < 16 ? length - offset : 16;
+
+        memset(plain, 0, sizeof(plain));
+        memcpy(plain, data + offset, chunk);
+        MAP_AES256_encryptData(AES256_BASE, plain, encrypted + offset);
+    }
+}
+
+void block_cache_init(const uint8_t *key)
+{
+    memset(entries, 0, sizeof(entries));
+    memcpy(cipherKey, key, sizeof(cipherKey));
+    useCounter = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void block_cache_invalidate(const uint8_t *data, uint32_t length)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < BLOCK_CACHE_ENTRIES; ii++)
+        if (entries[ii].address >= data && entries[ii].address < data + length)
+            entries[ii].address = NULL;
+}
+
+bool block_cache_process(const uint8_t *data, uint32_t length, uint32_t generation,
+                         uint32_t *crc, uint8_t *encrypted)
+{
+    uint32_t padded = (length + 15) & ~15u;
+    block_cache_entry *victim = &entries[0];
+    block_cache_entry *entry = NULL;
+    uint32_t ii;
+
+    for (ii = 0; ii < BLOCK_CACHE_ENTRIES; ii++)
+    {
+        block_cache_entry *candidate = &entries[ii];
+
+        if (candidate->address == data && candidate->length == length)
+        {
+            entry = candidate;
+            break;
+        }
+
+        if (victim->address != NULL &&
+            (candidate->address == NULL || candidate->lastUse < victim->lastUse))
+            victim = candidate;
+    }
+
+    if (entry && entry->generation == generation)
+    {
+        entry->lastUse = ++useCounter;
+        stats.hits++;
+
+        *crc = entry->crc;
+        memcpy(encrypted, entry->encrypted, padded);
+        return true;
+    }
+
+    /* Stale entry of the same block is refreshed in place */
+    if (!entry)
+    {
+        entry = victim;
+        if (entry->address != NULL)
+            stats.evictions++;
+    }
+
+    stats.misses++;
+
+    entry->address = data;
+    entry->length = length;
+    entry->generation = generation;
+    entry->lastUse = ++useCounter;
+    entry->crc = crcBlock(data, length);
+    encryptBlock(data, length, entry->encrypted);
+
+    *crc = entry->crc;
+    memcpy(encrypted, entry->encrypted, padded);
+    return false;
+}
+
+uint32_t block_cache_process_buffer(const uint8_t *data, uint32_t length,
+                                    const uint32_t *generations, uint32_t *crcs,
+                                    uint8_t *encrypted)
+{
+    uint32_t hits = 0;
+    uint32_t offset, block = 0;
+
+    for (offset = 0; offset < length; offset += BLOCK_CACHE_BLOCK_SIZE, block++)
+    {
+        uint32_t chunk = length - offset < BLOCK_CACHE_BLOCK_SIZE ?
+                         length - offset : BLOCK_CACHE_BLOCK_SIZE;
+
+        hits += block_cache_process(data + offset, chunk, generations[block],
+                                    &crcs[block], encrypted + offset);
+    }
+
+    return hits;
+}
+
+const block_cache_stats *block_cache_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * CRC32/AES256 block cache
+ *
+ * Remembers the CRC32 and the AES256 ciphertext of recently processed blocks,
+ * keyed by (address, length, generation). The generation is a counter the
+ * owner of the buffer bumps whenever it writes to a block, so an unchanged
+ * block is recognized without reading it: a hit copies the cached results
+ * and skips the CRC32 and AES256 modules entirely.
+ *
+ * The cache holds BLOCK_CACHE_ENTRIES blocks of up to BLOCK_CACHE_BLOCK_SIZE
+ * bytes and evicts the least recently used one. Ciphertext is AES256 in ECB
+ * mode like encrypt_message(), with a short last AES block padded with
+ * zeros; CRC32 is the standard CRC32 of the block.
+ ******************************************************************************/
+#ifndef BLOCK_CACHE_H_
+#define BLOCK_CACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BLOCK_CACHE_ENTRIES     16
+#define BLOCK_CACHE_BLOCK_SIZE  64      /* multiple of the 16-byte AES block */
+
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+} block_cache_stats;
+
+/* Empty the cache and set the 256-bit cipher key for all later blocks */
+void block_cache_init(const uint8_t *key);
+
+/* Drop every cached block of [data, data + length) */
+void block_cache_invalidate(const uint8_t *data, uint32_t length);
+
+/* CRC32 and ciphertext of one block of up to BLOCK_CACHE_BLOCK_SIZE bytes.
+ * encrypted receives length rounded up to 16 bytes. Returns true on a hit. */
+bool block_cache_process(const uint8_t *data, uint32_t length, uint32_t generation,
+                         uint32_t *crc, uint8_t *encrypted);
+
+/* Whole buffer in BLOCK_CACHE_BLOCK_SIZE blocks, with one generation per
+ * block; crcs gets one CRC32 per block. Returns the number of hits. */
+uint32_t block_cache_process_buffer(const uint8_t *data, uint32_t length,
+                                    const uint32_t *generations, uint32_t *crcs,
+                                    uint8_t *encrypted);
+
+const block_cache_stats *block_cache_get_stats(void);
+
+#endif /* BLOCK_CACHE_H_ */
@@ -0,0 +1,324 @@
+/*******************************************************************************
+ * DMA memcpy/memset
+ *
+ * Bytes before the first word boundary and after the last one are always
+ * handled by the CPU, so the DMA part of a copy with equally aligned source
+ * and destination is all 32-bit items; otherwise it is bytes. memset repeats
+ * one fixed source word.
+ *
+ * Calibration times both paths with the DWT cycle counter, like
+ * crc32_dispatch_calibrate() in Lab3.3. The counter stops in LPM0, so it
+ * spins on the busy flag instead of sleeping in dma_mem_wait().
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "dma_mem.h"
+#include "dma_manager.h"
+
+#define CALIBRATION_MIN_LENGTH  16
+#define CALIBRATION_RUNS        3
+
+/* Until calibrated: everything on the CPU */
+static dma_mem_crossover crossover = { UINT32_MAX, UINT32_MAX };
+
+/* Current transfer, advanced by the completion interrupt */
+static uint8_t *memDst;
+static const uint8_t *memSrc;
+static uint32_t memRemaining;           /* items */
+static uint32_t memItemShift;           /* log2 of the item size */
+static bool memFill;                    /* fixed source */
+static uint32_t memControl;
+static volatile bool memBusy;
+
+/* memset source, replicated to a word */
+static uint32_t memFillWord;
+
+static void cpuCopy(uint8_t *dst, const uint8_t *src, uint32_t length)
+{
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) == 0)
+    {
+        uint32_t *dstWords;
+        const uint32_t *srcWords;
+
+        while (length && ((uintptr_t)dst & 3))
+        {
+            *dst++ = *src++;
+            length--;
+        }
+
+        dstWords = (uint32_t *)dst;
+        srcWords = (const uint32_t *)src;
+
+        while (length >= 16)
+        {
+            dstWords[0] = srcWords[0];
+            dstWords[1] = srcWords[1];
+            dstWords[2] = srcWords[2];
+            dstWords[3] = srcWords[3];
+            dstWords += 4;
+            srcWords += 4;
+            length -= 16;
+        }
+        while (length >= 4)
+        {
+            *dstWords++ = *srcWords++;
+            length -= 4;
+        }
+
+        dst = (uint8_t *)dstWords;
+        src = (const uint8_t *)srcWords;
+    }
+
+    while (length--)
+        *dst++ = *src++;
+}
+
+static void cpuSet(uint8_t *dst, uint8_t value, uint32_t length)
+{
+    uint32_t word = value * 0x01010101u;
+    uint32_t *dstWords;
+
+    while (length && ((uintptr_t)dst & 3))
+    {
+        *dst++ = value;
+        length--;
+    }
+
+    dstWords = (uint32_t *)dst;
+
+    while (length >= 16)
+    {
+        dstWords[0] = word;
+        dstWords[1] = word;
+        dstWords[2] = word;
+        dstWords[3] = word;
+        dstWords += 4;
+        length -= 16;
+    }
+    while (length >= 4)
+    {
+        *dstWords++ = word;
+        length -= 4;
+    }
+
+    dst = (uint8_t *)dstWords;
+    while (length--)
+        *dst++ = value;
+}
+
+/* Program the channel for the next (up to) 1024 items and trigger it */
+static void arm(void)
+{
+    uint32_t items = memRemaining > 1024 ? 1024 : memRemaining;
+
+    MAP_DMA_setChannelTransfer(DMA_MEM_CHANNEL | UDMA_PRI_SELECT,
+                               UDMA_MODE_AUTO,
+                               (void*) memSrc,
+                               (void*) memDst,
+                               items);
+    dma_manager_transfer(DMA_MEM_CHANNEL, items, memControl);
+
+    MAP_DMA_enableChannel(DMA_MEM_CHANNEL);
+    MAP_DMA_requestSoftwareTransfer(DMA_MEM_CHANNEL);
+}
+
+/* Start the DMA part of a copy (src != NULL) or fill */
+static void dmaStart(uint8_t *dst, const uint8_t *src, uint8_t value, uint32_t length)
+{
+    dma_mem_wait();
+
+    memFill = (src == NULL);
+    memItemShift = (memFill || (((uintptr_t)dst ^ (uintptr_t)src) & 3) == 0) ? 2 : 0;
+
+    if (memItemShift)
+    {
+        uint32_t head = (4 - ((uintptr_t)dst & 3)) & 3;
+        uint32_t tail;
+
+        if (head > length)
+            head = length;
+        tail = (length - head) & 3;
+
+        /* Head and tail on the CPU, words in between by DMA */
+        if (memFill)
+        {
+            cpuSet(dst, value, head);
+            cpuSet(dst + length - tail, value, tail);
+        }
+        else
+        {
+            cpuCopy(dst, src, head);
+            cpuCopy(dst + length - tail, src + length - tail, tail);
+            src += head;
+        }
+
+        dst += head;
+        length -= head + tail;
+    }
+
+    memDst = dst;
+    memRemaining = length >> memItemShift;
+
+    if (memRemaining == 0)
+        return;
+
+    if (memFill)
+    {
+        memFillWord = value * 0x01010101u;
+        memSrc = (const uint8_t *)&memFillWord;
+        memControl = UDMA_SIZE_32 | UDMA_SRC_INC_NONE | UDMA_DST_INC_32 | UDMA_ARB_1024;
+    }
+    else
+    {
+        memSrc = src;
+        memControl = (memItemShift ? UDMA_SIZE_32 | UDMA_SRC_INC_32 | UDMA_DST_INC_32 :
+                                     UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_8) | UDMA_ARB_1024;
+    }
+
+    MAP_DMA_setChannelControl(DMA_MEM_CHANNEL | UDMA_PRI_SELECT, memControl);
+
+    dma_manager_job_start(DMA_MEM_CHANNEL);
+    memBusy = true;
+    arm();
+}
+
+void dma_memcpy_async(void *dst, const void *src, uint32_t length)
+{
+    if (length < crossover.copyMin)
+    {
+        dma_mem_wait();
+        cpuCopy(dst, src, length);
+        return;
+    }
+
+    dmaStart(dst, src, 0, length);
+}
+
+void dma_memset_async(void *dst, uint8_t value, uint32_t length)
+{
+    if (length < crossover.setMin)
+    {
+        dma_mem_wait();
+        cpuSet(dst, value, length);
+        return;
+    }
+
+    dmaStart(dst, NULL, value, length);
+}
+
+void dma_memcpy(void *dst, const void *src, uint32_t length)
+{
+    dma_memcpy_async(dst, src, length);
+    dma_mem_wait();
+}
+
+void dma_memset(void *dst, uint8_t value, uint32_t length)
+{
+    dma_memset_async(dst, value, length);
+    dma_mem_wait();
+}
+
+bool dma_mem_busy(void)
+{
+    return memBusy;
+}
+
+void dma_mem_wait(void)
+{
+    /* Check and sleep with interrupts masked: WFI still wakes on the pending
+     * DMA interrupt, so a completion between the two cannot be missed */
+    bool wasMasked = MAP_Interrupt_disableMaster();
+
+    while (memBusy)
+    {
+        MAP_PCM_gotoLPM0();
+        MAP_Interrupt_enableMaster();
+        MAP_Interrupt_disableMaster();
+    }
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+void dma_mem_interrupt(void)
+{
+    uint32_t items = memRemaining > 1024 ? 1024 : memRemaining;
+
+    MAP_DMA_disableChannel(DMA_MEM_CHANNEL);
+    memDst += items << memItemShift;
+    if (!memFill)
+        memSrc += items << memItemShift;
+    memRemaining -= items;
+
+    if (memRemaining > 0)
+    {
+        arm();
+    }
+    else
+    {
+        memBusy = false;
+        dma_manager_job_done(DMA_MEM_CHANNEL);
+    }
+}
+
+static uint32_t timeCopy(bool useDma, bool fill, void *dst, const void *src, uint32_t length)
+{
+    uint32_t best = UINT32_MAX;
+    int run;
+
+    for (run = 0; run < CALIBRATION_RUNS; run++)
+    {
+        uint32_t t0 = DWT->CYCCNT;
+
+        if (useDma)
+            dmaStart(dst, fill ? NULL : src, 0, length);
+        else if (fill)
+            cpuSet(dst, 0, length);
+        else
+            cpuCopy(dst, src, length);
+        while (memBusy);
+
+        uint32_t cycles = DWT->CYCCNT - t0;
+        if (cycles < best)
+            best = cycles;
+    }
+
+    return best;
+}
+
+void dma_mem_calibrate(void *scratchDst, const void *scratchSrc, uint32_t length)
+{
+    uint32_t copyMin = UINT32_MAX, setMin = UINT32_MAX;
+    bool copyWins = true, setWins = true;
+    uint32_t size;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Largest power of two that fits the scratch buffers */
+    for (size = CALIBRATION_MIN_LENGTH; size * 2 <= length; size *= 2);
+
+    /* Walk down so each crossover is the smallest length from which DMA
+     * keeps winning at every larger size */
+    for (; size >= CALIBRATION_MIN_LENGTH; size /= 2)
+    {
+        copyWins = copyWins && timeCopy(true, false, scratchDst, scratchSrc, size) <
+                               timeCopy(false, false, scratchDst, scratchSrc, size);
+        if (copyWins)
+            copyMin = size;
+
+        setWins = setWins && timeCopy(true, true, scratchDst, scratchSrc, size) <
+                             timeCopy(false, true, scratchDst, scratchSrc, size);
+        if (setWins)
+            setMin = size;
+    }
+
+    crossover.copyMin = copyMin;
+    crossover.setMin = setMin;
+}
+
+void dma_mem_get(dma_mem_crossover *result)
+{
+    *result = crossover;
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * DMA memcpy/memset
+ *
+ * dma_memcpy() and dma_memset() move memory on DMA channel DMA_MEM_CHANNEL
+ * in auto mode, 32-bit items when source and destination allow it, 1024
+ * items per request. Below a crossover length the DMA setup and completion
+ * interrupt cost more than the copy itself, so shorter calls run a word-wise
+ * CPU loop instead. dma_mem_calibrate() measures the crossovers at startup;
+ * until then every call takes the CPU path.
+ *
+ * The _async variants return as soon as the transfer is started, so the CPU
+ * can compute while the DMA copies; dma_mem_wait() sleeps in LPM0 until it is
+ * done. One transfer at a time: starting another waits for the previous
+ * one. Calls that take the CPU path are complete when they return.
+ *
+ * Register the channel with dma_manager_init() under DMA_CH7_RESERVED0 with
+ * dma_mem_interrupt() as its handler. The lowest-priority channel keeps bulk
+ * copies from delaying peripheral transfers.
+ ******************************************************************************/
+#ifndef DMA_MEM_H_
+#define DMA_MEM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DMA_MEM_CHANNEL         7
+
+typedef struct
+{
+    uint32_t copyMin;           /* lengths from which DMA is faster */
+    uint32_t setMin;
+} dma_mem_crossover;
+
+/* Time the CPU and DMA paths on two scratch buffers of length bytes */
+void dma_mem_calibrate(void *scratchDst, const void *scratchSrc, uint32_t length);
+
+void dma_mem_get(dma_mem_crossover *crossover);
+
+void dma_memcpy(void *dst, const void *src, uint32_t length);
+void dma_memset(void *dst, uint8_t value, uint32_t length);
+
+void dma_memcpy_async(void *dst, const void *src, uint32_t length);
+void dma_memset_async(void *dst, uint8_t value, uint32_t length);
+
+bool dma_mem_busy(void);
+void dma_mem_wait(void);
+
+/* Completion handler for the DMA manager */
+void dma_mem_interrupt(void);
+
+#endif /* DMA_MEM_H_ */
@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * CRC32 module arbitration
+ *
+ * There is a single CRC32 module, and a seed written by one code path
+ * clobbers any computation another path has in flight, e.g. a UART frame
+ * checksummed from an ISR in the middle of a background image check.
+ *
+ * Clients claim the module with a lock-free owner token (LDREX/STREX, no
+ * interrupt masking) for the duration of one update. Each client keeps its
+ * running value in its own context and crc32_hw_update() restores it into
+ * the module before the data and saves it afterwards, so the handoff between
+ * clients is just the token. A client that finds the module taken does not
+ * wait: crc32_arbiter_update() continues its CRC in software and counts the
+ * contention. Since software and hardware compute the same register value,
+ * the result does not depend on which path ran.
+ *
+ * A client is identified by any non-null pointer that is unique to it, such
+ * as its crc32_ctx. MSP432 only.
+ ******************************************************************************/
+#ifndef CRC32_ARBITER_H_
+#define CRC32_ARBITER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    uint32_t grants;            /* completed ownerships of the CRC32 module */
+    uint32_t contentions;       /* acquire attempts that found it taken */
+    uint64_t holdCycles;        /* total time the module was owned */
+    uint32_t maxHoldCycles;     /* longest single ownership */
+    uint32_t maxFallbackCycles; /* longest software update after a contention */
+} crc32_arbiter_counters;
+
+/* Enable the DWT cycle counter used for the latency counters and clear them */
+void crc32_arbiter_init(void);
+
+/* Take the module for client; false (without waiting) if someone owns it */
+bool crc32_arbiter_acquire(const void *client);
+
+/* Hand the module back; only the owner can release it */
+void crc32_arbiter_release(const void *client);
+
+/* Current owner, NULL if the module is free */
+const void *crc32_arbiter_owner(void);
+
+/* Continue a raw CRC on the CRC32 module if it is free, in software otherwise */
+uint32_t crc32_arbiter_update(const void *client, uint32_t crc,
+                              const uint8_t *data, uint32_t length);
+
+const crc32_arbiter_counters *crc32_arbiter_stats(void);
+
+#endif /* CRC32_ARBITER_H_ */
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ * Boot-time image verification
+ *
+ * CRC32_PRIME is the linker's default algorithm: polynomial 0x04C11DB7,
+ * MSB-first, zero seed and no final XOR. The CRC32 module computes it with
+ * a zero seed, bytes written to CRC32DIRB and the result read from
+ * CRC32INIRES, which is the crc32_dma_start_reversed() path.
+ *
+ * crcTableStart/crcTableEnd are defined around .TI.crctab in
+ * msp432p401r.cmd. The section holds one CRC_TABLE per crc_table() operator;
+ * the tables are walked by their rec_size, so the layout of CRC_RECORD in
+ * the compiler's crc_tbl.h is all that is assumed.
+ *
+ * Sections are timed with Timer32 module 1 in MCLK ticks rather than the DWT
+ * cycle counter, which halts while the CPU waits in LPM0.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include <crc_tbl.h>
+
+#include "crc32_boot.h"
+#include "crc32_dma.h"
+#include "crc32_arbiter.h"
+
+extern const uint8_t crcTableStart[];
+extern const uint8_t crcTableEnd[];
+
+static crc32_boot_section sections[CRC32_BOOT_MAX_SECTIONS];
+static uint32_t sectionCount;
+static uint32_t recordCount;            /* in the tables, may exceed sectionCount */
+static bool started;
+static volatile uint32_t current;
+static volatile bool running;
+
+static void collectSections(void)
+{
+    const uint8_t *p = crcTableStart;
+    uint32_t ii;
+
+    sectionCount = 0;
+    recordCount = 0;
+
+    while (p + 8 <= crcTableEnd)
+    {
+        const CRC_TABLE *table = (const CRC_TABLE *)p;
+
+        /* Records beyond the limit are counted but not checked */
+        recordCount += table->num_recs;
+
+        for (ii = 0; ii < table->num_recs && sectionCount < CRC32_BOOT_MAX_SECTIONS; ii++)
+        {
+            const CRC_RECORD *record = (const CRC_RECORD *)((const uint8_t *)table->recs +
+                                                            ii * table->rec_size);
+            crc32_boot_section *section = &sections[sectionCount++];
+
+            section->addr = record->addr;
+            section->size = record->size;
+            section->expected = (uint32_t)record->crc_value;
+            section->actual = 0;
+            section->cycles = 0;
+
+            if (record->crc_alg_ID != CRC32_PRIME)
+                section->status = CRC32_BOOT_UNSUPPORTED;
+            else if (record->size == 0)
+                section->status = section->expected == 0 ? CRC32_BOOT_PASS : CRC32_BOOT_FAIL;
+            else
+                section->status = CRC32_BOOT_PENDING;
+        }
+
+        /* Next table, 8-byte aligned like the 64-bit CRC values in it */
+        p = (const uint8_t *)table->recs + table->num_recs * table->rec_size;
+        p = (const uint8_t *)(((uintptr_t)p + 7) & ~(uintptr_t)7);
+    }
+}
+
+/* Start the next pending section or finish; runs from the DMA interrupt */
+static void startNext(void)
+{
+    for (; current < sectionCount; current++)
+    {
+        crc32_boot_section *section = &sections[current];
+
+        if (section->status != CRC32_BOOT_PENDING)
+            continue;
+
+        MAP_CRC32_setSeed(0, CRC32_MODE);
+        section->cycles = MAP_Timer32_getValue(TIMER32_1_BASE);
+        crc32_dma_start_reversed((const uint8_t *)section->addr, section->size);
+        return;
+    }
+
+    crc32_dma_on_complete(0);
+    crc32_arbiter_release(sections);
+    running = false;
+}
+
+static void sectionDone(void)
+{
+    crc32_boot_section *section = &sections[current];
+
+    /* Timer32 counts down */
+    section->cycles -= MAP_Timer32_getValue(TIMER32_1_BASE);
+    section->actual = MAP_CRC32_getResult(CRC32_MODE);
+    section->status = section->actual == section->expected ? CRC32_BOOT_PASS : CRC32_BOOT_FAIL;
+
+    current++;
+    startNext();
+}
+
+bool crc32_boot_start(void)
+{
+    started = false;
+
+    if (!crc32_arbiter_acquire(sections))
+        return false;
+
+    MAP_Timer32_initModule(TIMER32_1_BASE, TIMER32_PRESCALER_1, TIMER32_32BIT,
+                           TIMER32_FREE_RUN_MODE);
+    MAP_Timer32_startTimer(TIMER32_1_BASE, 0);
+
+    collectSections();
+
+    current = 0;
+    started = true;
+    running = true;
+    crc32_dma_on_complete(sectionDone);
+    startNext();
+
+    return true;
+}
+
+bool crc32_boot_done(void)
+{
+    return !running;
+}
+
+bool crc32_boot_wait(void)
+{
+    uint32_t ii;
+
+    /* Check and sleep with interrupts masked: WFI still wakes on the pending
+     * DMA interrupt, so a completion between the two cannot be missed */
+    MAP_Interrupt_disableMaster();
+    while (running)
+    {
+        MAP_PCM_gotoLPM0();
+        MAP_Interrupt_enableMaster();
+        MAP_Interrupt_disableMaster();
+    }
+    MAP_Interrupt_enableMaster();
+
+    /* Not started, or only part of the image checked */
+    if (!started || recordCount > sectionCount)
+        return false;
+
+    for (ii = 0; ii < sectionCount; ii++)
+        if (sections[ii].status == CRC32_BOOT_FAIL)
+            return false;
+
+    return true;
+}
+
+const crc32_boot_section *crc32_boot_sections(uint32_t *count)
+{
+    *count = sectionCount;
+    return sections;
+}
+
+uint32_t crc32_boot_records(void)
+{
+    return recordCount;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * Boot-time image verification
+ *
+ * With gen_crc_table defined, msp432p401r.cmd makes the linker record the
+ * CRC of every initialized section (crc_table(crc_table_for_text) etc.) in
+ * CRC_TABLE structures (crc_tbl.h) collected in .TI.crctab.
+ * crc32_boot_start() walks those tables and recomputes every CRC32_PRIME
+ * record by DMA into the CRC32 module. Each section is chained from the DMA
+ * completion interrupt, so the CPU is free for peripheral init while the
+ * image is checked; crc32_boot_wait() sleeps in LPM0 until the last one.
+ *
+ * The CRC32 module is claimed through crc32_arbiter.h for the whole check.
+ * DMA channel 0 and Timer32 module 1 belong to the check until
+ * crc32_boot_done(); the DMA setup of crc32_dma.h must be in place before
+ * the start.
+ ******************************************************************************/
+#ifndef CRC32_BOOT_H_
+#define CRC32_BOOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_BOOT_MAX_SECTIONS 16
+
+typedef enum
+{
+    CRC32_BOOT_PENDING,
+    CRC32_BOOT_PASS,
+    CRC32_BOOT_FAIL,
+    CRC32_BOOT_UNSUPPORTED      /* record uses an algorithm other than CRC32_PRIME */
+} crc32_boot_status;
+
+typedef struct
+{
+    uint32_t addr;
+    uint32_t size;
+    uint32_t expected;          /* CRC from the linker */
+    uint32_t actual;            /* CRC of the flash contents */
+    uint32_t cycles;            /* MCLK ticks from DMA start to completion */
+    crc32_boot_status status;
+} crc32_boot_section;
+
+/* Collect the records and start checking; false if the CRC32 module is busy */
+bool crc32_boot_start(void);
+
+/* All sections checked */
+bool crc32_boot_done(void);
+
+/* Sleep until the check is done; true if every supported section passed.
+ * False if the check never started or the tables hold more records than
+ * CRC32_BOOT_MAX_SECTIONS, in which case only the first ones were checked. */
+bool crc32_boot_wait(void);
+
+/* Results in .TI.crctab order */
+const crc32_boot_section *crc32_boot_sections(uint32_t *count);
+
+/* Records in the tables, checked or not */
+uint32_t crc32_boot_records(void);
+
+#endif /* CRC32_BOOT_H_ */
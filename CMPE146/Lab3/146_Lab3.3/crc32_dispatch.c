@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * CRC32 backend dispatcher
+ *
+ * Calibration times each backend with the DWT cycle counter, so it does not
+ * disturb the Timer32 modules the labs use for their own measurements.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "crc32_dispatch.h"
+#include "crc32_engine.h"
+#include "crc32_hw.h"
+#include "crc32_dma.h"
+#include "crc32_arbiter.h"
+
+#define CALIBRATION_MIN_LENGTH  16
+#define CALIBRATION_RUNS        3
+
+typedef uint32_t (*crc32_backend_fn)(uint32_t crc, const uint8_t *data, uint32_t length);
+
+static const crc32_backend_fn backends[CRC32_BACKEND_COUNT] =
+{
+    crc32_update, crc32_hw_update, crc32_dma_update
+};
+
+/* Until calibrated: everything in software */
+static crc32_crossover crossover = { CRC32_CROSSOVER_MAGIC, UINT32_MAX, UINT32_MAX };
+static crc32_backend_stats stats[CRC32_BACKEND_COUNT];
+
+static uint32_t timeBackend(crc32_backend_t backend, const uint8_t *data, uint32_t length)
+{
+    uint32_t best = UINT32_MAX;
+    int run;
+
+    for (run = 0; run < CALIBRATION_RUNS; run++)
+    {
+        uint32_t t0 = DWT->CYCCNT;
+        backends[backend](CRC32_INIT, data, length);
+        uint32_t cycles = DWT->CYCCNT - t0;
+
+        if (cycles < best)
+            best = cycles;
+    }
+
+    return best;
+}
+
+void crc32_dispatch_calibrate(const uint8_t *scratch, uint32_t length)
+{
+    uint32_t hwMin = UINT32_MAX;
+    uint32_t dmaMin = UINT32_MAX;
+    bool hwWins = true, dmaWins = true;
+    uint32_t size;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Largest power of two that fits the scratch buffer */
+    for (size = CALIBRATION_MIN_LENGTH; size * 2 <= length; size *= 2);
+
+    /* Walk down so each crossover is the smallest length from which the
+     * backend keeps winning at every larger size */
+    for (; size >= CALIBRATION_MIN_LENGTH; size /= 2)
+    {
+        uint32_t sw = timeBackend(CRC32_BACKEND_SW, scratch, size);
+        uint32_t hw = timeBackend(CRC32_BACKEND_HW, scratch, size);
+        uint32_t dma = timeBackend(CRC32_BACKEND_DMA, scratch, size);
+
+        hwWins = hwWins && hw < sw;
+        if (hwWins)
+            hwMin = size;
+
+        dmaWins = dmaWins && dma < sw && dma < hw;
+        if (dmaWins)
+            dmaMin = size;
+    }
+
+    crossover.hwMin = hwMin;
+    crossover.dmaMin = dmaMin;
+}
+
+bool crc32_dispatch_load(const crc32_crossover *table)
+{
+    if (table->magic != CRC32_CROSSOVER_MAGIC)
+        return false;
+
+    crossover = *table;
+    return true;
+}
+
+void crc32_dispatch_get(crc32_crossover *table)
+{
+    *table = crossover;
+}
+
+crc32_backend_t crc32_dispatch_select(uint32_t length)
+{
+    if (length >= crossover.dmaMin)
+        return CRC32_BACKEND_DMA;
+    if (length >= crossover.hwMin)
+        return CRC32_BACKEND_HW;
+
+    return CRC32_BACKEND_SW;
+}
+
+uint32_t crc32(const uint8_t *data, uint32_t length)
+{
+    crc32_backend_t backend = crc32_dispatch_select(length);
+    uint32_t crc;
+
+    /* Someone else owns the CRC32 module: stay in software */
+    if (backend != CRC32_BACKEND_SW && !crc32_arbiter_acquire(&crossover))
+        backend = CRC32_BACKEND_SW;
+
+    stats[backend].calls++;
+    stats[backend].bytes += length;
+
+    crc = ~backends[backend](CRC32_INIT, data, length);
+
+    if (backend != CRC32_BACKEND_SW)
+        crc32_arbiter_release(&crossover);
+
+    return crc;
+}
+
+const crc32_backend_stats *crc32_dispatch_stats(void)
+{
+    return stats;
+}
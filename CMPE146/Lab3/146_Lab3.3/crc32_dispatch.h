@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * CRC32 backend dispatcher
+ *
+ * crc32() computes the standard CRC32 of a buffer on whichever backend is
+ * fastest for its length: the software engine for small blocks, the CPU-fed
+ * CRC32 module for medium ones and DMA for large ones, where the setup and
+ * interrupt cost is amortized. The crossover lengths come from
+ * crc32_dispatch_calibrate(), which times all three backends at boot, or
+ * from a table saved earlier with crc32_dispatch_get() and handed back to
+ * crc32_dispatch_load() to skip the calibration.
+ *
+ * The CRC32 module and DMA backends claim the module through crc32_arbiter.h;
+ * if another client owns it, the call runs in software instead.
+ *
+ * Every backend counts its calls and bytes so the decisions can be checked
+ * in the field. The DMA backend needs the DMA setup described in crc32_dma.h.
+ ******************************************************************************/
+#ifndef CRC32_DISPATCH_H_
+#define CRC32_DISPATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_CROSSOVER_MAGIC   0x43524358      /* "CRCX" */
+
+typedef enum
+{
+    CRC32_BACKEND_SW,
+    CRC32_BACKEND_HW,
+    CRC32_BACKEND_DMA,
+    CRC32_BACKEND_COUNT
+} crc32_backend_t;
+
+/* Lengths from which the CRC32 module resp. DMA is the fastest backend */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t hwMin;
+    uint32_t dmaMin;
+} crc32_crossover;
+
+typedef struct
+{
+    uint32_t calls;
+    uint64_t bytes;
+} crc32_backend_stats;
+
+/* Time every backend on scratch (up to length bytes) and derive the table */
+void crc32_dispatch_calibrate(const uint8_t *scratch, uint32_t length);
+
+/* Use a persisted table; returns false (and changes nothing) if it is invalid */
+bool crc32_dispatch_load(const crc32_crossover *table);
+
+/* Current table, e.g. to persist it after calibration */
+void crc32_dispatch_get(crc32_crossover *table);
+
+/* Backend crc32() uses for a block of this length */
+crc32_backend_t crc32_dispatch_select(uint32_t length);
+
+/* Standard (inverted) CRC32 of a buffer on the selected backend */
+uint32_t crc32(const uint8_t *data, uint32_t length);
+
+/* Per-backend counters, indexed by crc32_backend_t */
+const crc32_backend_stats *crc32_dispatch_stats(void);
+
+#endif /* CRC32_DISPATCH_H_ */
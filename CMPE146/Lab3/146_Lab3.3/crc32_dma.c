@@ -0,0 +1,271 @@
+/*******************************************************************************
+ * CRC32 over DMA
+ *
+ * Feeds the CRC32 module from memory through DMA channel 0 in auto mode,
+ * 1024 items per transfer. crc32_dma_interrupt() re-arms the channel for the
+ * next chunk and sets dma_done after the last one.
+ *
+ * In ping-pong mode both control structures of channel 0 hold a chunk. When
+ * one finishes, the handler first requests the other, which is already
+ * programmed, and only then refills the finished one with the chunk after
+ * that, so the reprogramming overlaps the transfer instead of preceding it.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "crc32_dma.h"
+#include "crc32_hw.h"
+#include "dma_manager.h"
+
+volatile int dma_done;
+
+/* Current DMA source and items left, advanced by the completion interrupt */
+static const uint8_t *dmaSource;
+static int dmaRemaining;
+static int dmaItemSize = 1;
+
+/* Bytes after the last whole word of a word-wide transfer, fed on completion */
+static const uint8_t *dmaTail;
+static int dmaTailLength;
+
+/* CRC32DI for reflected CRCs, CRC32DIRB for MSB-first ones */
+static volatile void *dmaDestination = &CRC32->DI32;
+
+static void (*dmaCallback)(void);
+
+/* Ping-pong state: chunks armed but not finished, and the structure that
+ * finishes next */
+static bool dmaPingPong;
+static int dmaChunksPending;
+static uint32_t dmaActiveSelect;
+
+/* Items between rearbitrations, UDMA_ARB_1024 unless a client lowers it */
+static uint32_t dmaArbitration = UDMA_ARB_1024;
+
+/* Program the DMA channel for the next (up to) 1024 items and trigger it */
+static void crc32_dma_arm(void) {
+    int items = dmaRemaining > 1024 ? 1024 : dmaRemaining;
+
+    MAP_DMA_setChannelTransfer(CRC32_DMA_CHANNEL | UDMA_PRI_SELECT,
+                               UDMA_MODE_AUTO,
+                               (void*) dmaSource,
+                               (void*) dmaDestination,
+                               items);
+    dma_manager_transfer(CRC32_DMA_CHANNEL, items, dmaArbitration);
+
+    /* A ping-pong or scatter-gather run can end on the alternate structure,
+     * and the controller does not switch back by itself */
+    MAP_DMA_disableChannelAttribute(CRC32_DMA_CHANNEL, UDMA_ATTR_ALTSELECT);
+
+    /* Enabling DMA Channel 0 */
+    MAP_DMA_enableChannel(CRC32_DMA_CHANNEL);
+
+    /* Forcing a software transfer on DMA Channel 0 */
+    MAP_DMA_requestSoftwareTransfer(CRC32_DMA_CHANNEL);
+}
+
+/* Program one control structure with the next (up to) 1024 items; the last
+ * chunk is a basic transfer so the ping-pong cycle ends after it */
+static void crc32_dma_fill(uint32_t select) {
+    int items = dmaRemaining > 1024 ? 1024 : dmaRemaining;
+
+    MAP_DMA_setChannelTransfer(CRC32_DMA_CHANNEL | select,
+                               dmaRemaining > 1024 ? UDMA_MODE_PINGPONG : UDMA_MODE_BASIC,
+                               (void*) dmaSource,
+                               (void*) &CRC32->DI32,
+                               items);
+    dma_manager_transfer(CRC32_DMA_CHANNEL, items, UDMA_ARB_1024);
+
+    dmaSource += items;
+    dmaRemaining -= items;
+    dmaChunksPending++;
+}
+
+void crc32_dma_start(const uint8_t *data, int length) {
+    dma_manager_job_start(CRC32_DMA_CHANNEL);
+    dmaPingPong = false;
+    dmaSource = data;
+    dmaRemaining = length;
+    dmaItemSize = 1;
+    dmaTailLength = 0;
+    dmaDestination = &CRC32->DI32;
+    dma_done = 0;
+
+    /* Setting Control Indexes: byte source, fixed destination at the CRC32
+     * data in register */
+    MAP_DMA_setChannelControl(CRC32_DMA_CHANNEL | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | dmaArbitration);
+
+    crc32_dma_arm();
+}
+
+void crc32_dma_start_words(const uint8_t *data, int length) {
+    dma_manager_job_start(CRC32_DMA_CHANNEL);
+    dmaPingPong = false;
+
+    while (length && ((uintptr_t)data & 3)) {
+        MAP_CRC32_set8BitData(*data++, CRC32_MODE);
+        length--;
+    }
+
+    dmaSource = data;
+    dmaRemaining = length / 4;
+    dmaItemSize = 4;
+    dmaTail = data + (length & ~3);
+    dmaTailLength = length & 3;
+    dmaDestination = &CRC32->DI32;
+    dma_done = 0;
+
+    /* No whole word: the interrupt feeds the tail and finishes the job, so
+     * it completes like any other */
+    if (dmaRemaining == 0) {
+        dma_manager_pend(CRC32_DMA_CHANNEL);
+        return;
+    }
+
+    MAP_DMA_setChannelControl(CRC32_DMA_CHANNEL | UDMA_PRI_SELECT,
+                              UDMA_SIZE_32 | UDMA_SRC_INC_32 | UDMA_DST_INC_NONE | dmaArbitration);
+
+    crc32_dma_arm();
+}
+
+void crc32_dma_start_reversed(const uint8_t *data, int length) {
+    dma_manager_job_start(CRC32_DMA_CHANNEL);
+    dmaPingPong = false;
+    dmaSource = data;
+    dmaRemaining = length;
+    dmaItemSize = 1;
+    dmaTailLength = 0;
+    dmaDestination = &CRC32->DIRB32;
+    dma_done = 0;
+
+    MAP_DMA_setChannelControl(CRC32_DMA_CHANNEL | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | dmaArbitration);
+
+    crc32_dma_arm();
+}
+
+void crc32_dma_start_pingpong(const uint8_t *data, int length) {
+    dma_manager_job_start(CRC32_DMA_CHANNEL);
+    dmaPingPong = true;
+    dmaSource = data;
+    dmaRemaining = length;
+    dmaChunksPending = 0;
+    dmaActiveSelect = UDMA_PRI_SELECT;
+    dmaTailLength = 0;
+    dma_done = 0;
+
+    if (length == 0) {
+        dma_done = 1;
+        dma_manager_job_done(CRC32_DMA_CHANNEL);
+        return;
+    }
+
+    /* Each software request moves one arbitration burst, so a whole chunk
+     * has to be a single burst */
+    MAP_DMA_setChannelControl(CRC32_DMA_CHANNEL | UDMA_PRI_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1024);
+    MAP_DMA_setChannelControl(CRC32_DMA_CHANNEL | UDMA_ALT_SELECT,
+                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1024);
+
+    MAP_DMA_disableChannelAttribute(CRC32_DMA_CHANNEL, UDMA_ATTR_ALTSELECT);
+    crc32_dma_fill(UDMA_PRI_SELECT);
+    if (dmaRemaining > 0)
+        crc32_dma_fill(UDMA_ALT_SELECT);
+
+    MAP_DMA_enableChannel(CRC32_DMA_CHANNEL);
+    MAP_DMA_requestSoftwareTransfer(CRC32_DMA_CHANNEL);
+}
+
+void crc32_dma_start_tasks(const void *tasks, uint32_t taskCount) {
+    const DMA_ControlTable *task = tasks;
+    uint32_t ii;
+
+    dma_manager_job_start(CRC32_DMA_CHANNEL);
+    dmaPingPong = false;
+    dmaRemaining = 0;
+    dmaTailLength = 0;
+    dma_done = 0;
+
+    /* Primary structure copies each task to the alternate one, no requests
+     * in between; the completion interrupt comes after the last task */
+    MAP_DMA_disableChannelAttribute(CRC32_DMA_CHANNEL, UDMA_ATTR_ALTSELECT);
+    MAP_DMA_setChannelScatterGather(CRC32_DMA_CHANNEL, taskCount, (void*) tasks, 0);
+
+    /* Counted as armed all at once, one cycle per task */
+    for (ii = 0; ii < taskCount; ii++)
+        dma_manager_transfer(CRC32_DMA_CHANNEL,
+                             ((task[ii].control & UDMA_CHCTL_XFERSIZE_M) >> UDMA_CHCTL_XFERSIZE_S) + 1,
+                             task[ii].control);
+
+    MAP_DMA_enableChannel(CRC32_DMA_CHANNEL);
+    MAP_DMA_requestSoftwareTransfer(CRC32_DMA_CHANNEL);
+}
+
+void crc32_dma_set_arbitration(uint32_t arbitration, bool highPriority) {
+    dmaArbitration = arbitration;
+
+    if (highPriority)
+        MAP_DMA_enableChannelAttribute(CRC32_DMA_CHANNEL, UDMA_ATTR_HIGH_PRIORITY);
+    else
+        MAP_DMA_disableChannelAttribute(CRC32_DMA_CHANNEL, UDMA_ATTR_HIGH_PRIORITY);
+}
+
+void crc32_dma_get_arbitration(uint32_t *arbitration, bool *highPriority) {
+    *arbitration = dmaArbitration;
+    *highPriority = (MAP_DMA_getChannelAttribute(CRC32_DMA_CHANNEL) & UDMA_ATTR_HIGH_PRIORITY) != 0;
+}
+
+void crc32_dma_on_complete(void (*callback)(void)) {
+    dmaCallback = callback;
+}
+
+uint32_t crc32_dma_update(uint32_t crc, const uint8_t *data, uint32_t length) {
+    crc32_hw_restore(crc);
+    crc32_dma_start_words(data, length);
+
+    while(dma_done != 1);
+
+    return crc32_hw_save();
+}
+
+void crc32_dma_interrupt(void)
+{
+    if (dmaPingPong) {
+        uint32_t finished = dmaActiveSelect;
+
+        dmaActiveSelect = finished == UDMA_PRI_SELECT ? UDMA_ALT_SELECT : UDMA_PRI_SELECT;
+
+        if (--dmaChunksPending > 0) {
+            /* Other half is armed: start it, then refill the idle one */
+            MAP_DMA_requestSoftwareTransfer(CRC32_DMA_CHANNEL);
+            if (dmaRemaining > 0)
+                crc32_dma_fill(finished);
+            return;
+        }
+
+        MAP_DMA_disableChannel(CRC32_DMA_CHANNEL);
+        dma_done = 1;
+        dma_manager_job_done(CRC32_DMA_CHANNEL);
+
+        if (dmaCallback)
+            dmaCallback();
+        return;
+    }
+
+    MAP_DMA_disableChannel(CRC32_DMA_CHANNEL);
+
+    if (dmaRemaining > 1024) {
+        dmaSource += 1024 * dmaItemSize;
+        dmaRemaining -= 1024;
+        crc32_dma_arm();
+    } else {
+        dmaRemaining = 0;
+        crc32_hw_feed(dmaTail, dmaTailLength);
+        dma_done = 1;
+        dma_manager_job_done(CRC32_DMA_CHANNEL);
+
+        if (dmaCallback)
+            dmaCallback();
+    }
+}
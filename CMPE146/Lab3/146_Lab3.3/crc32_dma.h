@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * CRC32 over DMA
+ *
+ * Channel CRC32_DMA_CHANNEL belongs to this module: register it with
+ * dma_manager_init() under DMA_CH0_RESERVED0 with crc32_dma_interrupt() as
+ * its handler, as done at the top of main().
+ ******************************************************************************/
+#ifndef CRC32_DMA_H_
+#define CRC32_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_DMA_CHANNEL       0
+
+/* Set by the completion interrupt once the last item has been fed */
+extern volatile int dma_done;
+
+/* Start feeding length bytes to the CRC32 module through DMA channel 0 */
+void crc32_dma_start(const uint8_t *data, int length);
+
+/*
+ * Same as crc32_dma_start() with a quarter of the bus transactions: bytes up to
+ * the first word boundary are written by the CPU, the aligned middle goes to
+ * CRC32DI as 32-bit DMA items and the remaining tail bytes are written from
+ * the completion interrupt. The CRC is identical to the byte transfer.
+ * Under one whole word the interrupt is raised from software, so dma_done
+ * is only set once it has run.
+ */
+void crc32_dma_start_words(const uint8_t *data, int length);
+
+/* Byte transfer to CRC32DIRB for MSB-first CRCs: the module takes each byte
+ * bit-reversed, which is MAP_CRC32_set8BitDataReversed() per byte. Read the
+ * result with MAP_CRC32_getResult(). */
+void crc32_dma_start_reversed(const uint8_t *data, int length);
+
+/*
+ * Same result as crc32_dma_start() for transfers over 1024 bytes, using the
+ * primary and alternate control structures in ping-pong mode: the completion
+ * interrupt starts the next chunk before it refills the structure that just
+ * finished. Always runs at UDMA_ARB_1024.
+ */
+void crc32_dma_start_pingpong(const uint8_t *data, int length);
+
+/* Run a memory scatter-gather task list, e.g. from crc32_sg_build(); one
+ * completion interrupt for the whole list */
+void crc32_dma_start_tasks(const void *tasks, uint32_t taskCount);
+
+/* Arbitration size (UDMA_ARB_1 ... UDMA_ARB_1024) and priority of the
+ * transfers started from now on. UDMA_ARB_1 at normal priority lets every
+ * other channel in after each item, for background work. */
+void crc32_dma_set_arbitration(uint32_t arbitration, bool highPriority);
+
+/* Current settings, e.g. to restore them after background work; the
+ * priority is read back from the channel, wherever it was set */
+void crc32_dma_get_arbitration(uint32_t *arbitration, bool *highPriority);
+
+/* Called from the completion interrupt after dma_done is set, e.g. to start
+ * the next transfer without a gap; NULL to remove */
+void crc32_dma_on_complete(void (*callback)(void));
+
+/* Blocking word-wide DMA CRC, continuing from a raw register value like
+ * crc32_hw_update() */
+uint32_t crc32_dma_update(uint32_t crc, const uint8_t *data, uint32_t length);
+
+/* Completion handler for the DMA manager */
+void crc32_dma_interrupt(void);
+
+#endif /* CRC32_DMA_H_ */
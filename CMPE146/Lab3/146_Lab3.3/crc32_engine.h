@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * CRC32 software engine
+ *
+ * Table-driven software implementation of the standard (reflected, ISO-HDLC)
+ * CRC32 used by the MSP432 CRC32 module in CRC32_MODE. The lookup tables are
+ * generated at build time (crc32_tables.h) and live in MAIN flash.
+ *
+ * CRC32_TABLE_TIER trades flash for throughput; every tier exposes the same
+ * crc32_update()/calculateCRC32() API:
+ *
+ *     CRC32_TIER_NIBBLE    64 B     two 16-entry lookups per byte
+ *     CRC32_TIER_BYTE      1 KiB    one 256-entry lookup per byte
+ *     CRC32_TIER_SLICE8    8 KiB    slicing-by-8 (default)
+ *
+ * Override it with a predefined symbol, e.g. --define=CRC32_TABLE_TIER=0 in
+ * the CCS project or -DCRC32_TABLE_TIER=0 on the host.
+ *
+ * The file has no DriverLib dependency and builds for the MSP432 target as
+ * well as for a Linux host, e.g.
+ *
+ *     gcc -O2 -c crc32_engine.c
+ *
+ * The crc32_update_* functions work on the raw CRC register: seed them with
+ * CRC32_INIT and invert the final value (calculateCRC32() does both).
+ *
+ * Data that arrives in pieces is handled with a crc32_ctx: crc32_ctx_init(),
+ * any number of crc32_ctx_update() calls over arbitrary fragments, then
+ * crc32_ctx_final(). A context can run on the software engine or on the
+ * CRC32 module; the hardware engine restores the running value into the
+ * module before each fragment and saves it afterwards, so other users of the
+ * module can run in between. The shared engine additionally claims the
+ * module through crc32_arbiter.h and continues in software while another
+ * client owns it, so contexts in ISRs and in the background can mix safely.
+ * On the host both hardware engines fall back to software.
+ ******************************************************************************/
+#ifndef CRC32_ENGINE_H_
+#define CRC32_ENGINE_H_
+
+#include <stdint.h>
+
+#define CRC32_POLY              0xEDB88320
+#define CRC32_INIT              0xFFFFFFFF
+
+/* Engines a streaming context can run on */
+typedef enum
+{
+    CRC32_ENGINE_SW,
+    CRC32_ENGINE_HW,
+    CRC32_ENGINE_SHARED         /* CRC32 module when free, see crc32_arbiter.h */
+} crc32_engine_t;
+
+/* Running state of a streaming CRC32 */
+typedef struct
+{
+    uint32_t crc;               /* raw CRC register (reflected, not inverted) */
+    uint32_t length;            /* bytes processed so far */
+    crc32_engine_t engine;
+} crc32_ctx;
+
+/* Lookup table tiers */
+#define CRC32_TIER_NIBBLE       0
+#define CRC32_TIER_BYTE         1
+#define CRC32_TIER_SLICE8       2
+
+#ifndef CRC32_TABLE_TIER
+#define CRC32_TABLE_TIER        CRC32_TIER_SLICE8
+#endif
+
+/* Bit-serial reference, one shift per bit (the original lab implementation) */
+uint32_t crc32_update_bitwise(uint32_t crc, const uint8_t *data, uint32_t length);
+
+/* Two 16-entry table lookups per byte, available in every tier */
+uint32_t crc32_update_nibble(uint32_t crc, const uint8_t *data, uint32_t length);
+
+#if CRC32_TABLE_TIER >= CRC32_TIER_BYTE
+/* One 256-entry table lookup per byte */
+uint32_t crc32_update_bytewise(uint32_t crc, const uint8_t *data, uint32_t length);
+#endif
+
+#if CRC32_TABLE_TIER == CRC32_TIER_SLICE8
+/* Four and eight bytes per iteration using 4 resp. 8 tables */
+uint32_t crc32_update_slice4(uint32_t crc, const uint8_t *data, uint32_t length);
+uint32_t crc32_update_slice8(uint32_t crc, const uint8_t *data, uint32_t length);
+#endif
+
+/* Fastest kernel of the configured tier */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t length);
+
+/* CRC32 of a whole buffer */
+uint32_t calculateCRC32(uint8_t* data, uint32_t length);
+
+/* Streaming CRC32 */
+void crc32_ctx_init(crc32_ctx *ctx, crc32_engine_t engine);
+void crc32_ctx_update(crc32_ctx *ctx, const uint8_t *data, uint32_t length);
+uint32_t crc32_ctx_final(const crc32_ctx *ctx);
+
+/* CRC32 of A followed by B, from crcA = CRC32(A), crcB = CRC32(B) and the
+ * length of B in bytes, without touching the data. */
+uint32_t crc32_combine(uint32_t crcA, uint32_t crcB, uint32_t lenB);
+
+/* CRC32 of a totalLength-byte buffer after the length bytes at offset changed
+ * from oldBytes to newBytes, from its previous CRC32 oldCrc. CRC is linear,
+ * so only the XOR delta is hashed and then shifted past the rest of the
+ * buffer: O(length + log totalLength) instead of a full rescan. A range
+ * that does not fit inside the buffer (offset + length > totalLength) is
+ * rejected and oldCrc returned unchanged. */
+uint32_t crc32_update_range(uint32_t oldCrc, uint32_t totalLength, uint32_t offset,
+                            const uint8_t *oldBytes, const uint8_t *newBytes, uint32_t length);
+
+#endif /* CRC32_ENGINE_H_ */
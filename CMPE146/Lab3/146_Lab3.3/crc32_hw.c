@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * CRC32 module helpers
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "crc32_hw.h"
+
+/* Word access to the data-in register. CRC32DI is a 16-bit register; the
+ * peripheral bridge splits a word write into two halfword writes, low half
+ * first, which is exactly what CRC32_set32BitData() does by hand. */
+#define CRC32_DI32_WORD         (*(volatile uint32_t *)&CRC32->DI32)
+
+void crc32_hw_restore(uint32_t crc)
+{
+    MAP_CRC32_setSeed(__RBIT(crc), CRC32_MODE);
+}
+
+uint32_t crc32_hw_save(void)
+{
+    return MAP_CRC32_getResultReversed(CRC32_MODE);
+}
+
+void crc32_hw_feed(const uint8_t *data, uint32_t length)
+{
+    /* Unaligned head */
+    while (length && ((uintptr_t)data & 3))
+    {
+        MAP_CRC32_set8BitData(*data++, CRC32_MODE);
+        length--;
+    }
+
+    /* Little-endian words are processed in memory byte order */
+    while (length >= 4)
+    {
+        CRC32_DI32_WORD = *(const uint32_t *)data;
+        data += 4;
+        length -= 4;
+    }
+
+    /* Tail */
+    while (length--)
+        MAP_CRC32_set8BitData(*data++, CRC32_MODE);
+}
+
+uint32_t crc32_hw_update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    crc32_hw_restore(crc);
+    crc32_hw_feed(data, length);
+
+    return crc32_hw_save();
+}
+
+uint32_t crc32_hw_calculate(uint_fast8_t crcType, bool reflected, uint32_t crc,
+                            const uint8_t *data, uint32_t length)
+{
+    uint32_t width = (crcType == CRC16_MODE) ? 16 : 32;
+    uint32_t ii;
+
+    if (reflected && crcType == CRC32_MODE)
+        return crc32_hw_update(crc, data, length);
+
+    if (reflected)
+    {
+        MAP_CRC32_setSeed(__RBIT(crc) >> (32 - width), crcType);
+
+        for (ii = 0; ii < length; ii++)
+            MAP_CRC32_set8BitData(data[ii], crcType);
+
+        return MAP_CRC32_getResultReversed(crcType);
+    }
+
+    MAP_CRC32_setSeed(crc, crcType);
+
+    for (ii = 0; ii < length; ii++)
+        MAP_CRC32_set8BitDataReversed(data[ii], crcType);
+
+    return MAP_CRC32_getResult(crcType);
+}
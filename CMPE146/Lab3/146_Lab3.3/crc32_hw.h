@@ -0,0 +1,41 @@
+/*******************************************************************************
+ * CRC32 module helpers
+ *
+ * Thin layer over the DriverLib CRC32 API that speaks the same raw register
+ * representation as crc32_engine.h (reflected, not inverted), so a running
+ * CRC can move between the software engine and the CRC32 module.
+ *
+ * The module keeps the register MSB-first in CRC32INIRES and exposes the
+ * reflected value through CRC32RESR, which is why the lab code reads
+ * MAP_CRC32_getResultReversed(). Restoring a saved value therefore writes its
+ * bit-reversed form back as the seed.
+ *
+ * MSP432 only.
+ ******************************************************************************/
+#ifndef CRC32_HW_H_
+#define CRC32_HW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Load a raw CRC register value into the CRC32 module */
+void crc32_hw_restore(uint32_t crc);
+
+/* Read the raw CRC register value back from the CRC32 module */
+uint32_t crc32_hw_save(void);
+
+/* Feed bytes to the module in CRC32_MODE: byte writes up to the first word
+ * boundary, 32-bit writes to CRC32DI for the aligned middle and byte writes
+ * for the tail. The result is identical to feeding every byte. */
+void crc32_hw_feed(const uint8_t *data, uint32_t length);
+
+/* Continue a CRC on the CRC32 module: restore, feed length bytes, save */
+uint32_t crc32_hw_update(uint32_t crc, const uint8_t *data, uint32_t length);
+
+/* Raw CRC in CRC16_MODE or CRC32_MODE. A reflected CRC feeds CRC32DI and
+ * reads CRC32RESR, an MSB-first CRC feeds CRC32DIRB and reads CRC32INIRES;
+ * crc and the result are the register in the algorithm's own bit order. */
+uint32_t crc32_hw_calculate(uint_fast8_t crcType, bool reflected, uint32_t crc,
+                            const uint8_t *data, uint32_t length);
+
+#endif /* CRC32_HW_H_ */
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * Asynchronous CRC32 DMA job queue
+ *
+ * Handles count up from 1. Job h lives in slot h % CRC32_QUEUE_DEPTH from
+ * submission until job h + CRC32_QUEUE_DEPTH replaces it, so its result
+ * can still be read after completion. The jobs between completed + 1 and
+ * nextHandle - 1 are pending; the first of them is running. The queue owns
+ * the CRC32 module exactly while that range is not empty.
+ ******************************************************************************/
+#if defined(__MSP432P401R__)
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include "crc32_arbiter.h"
+#include "crc32_dma.h"
+#include "crc32_hw.h"
+#endif
+
+#include "crc32_queue.h"
+
+typedef struct
+{
+    crc32_job job;
+    uint32_t result;
+} crc32_queue_slot;
+
+static crc32_queue_slot slots[CRC32_QUEUE_DEPTH];
+static uint32_t nextHandle;
+static volatile uint32_t completed;
+
+static crc32_queue_slot *slotOf(uint32_t handle)
+{
+    return &slots[handle % CRC32_QUEUE_DEPTH];
+}
+
+void crc32_queue_init(void)
+{
+    nextHandle = 1;
+    completed = 0;
+}
+
+uint32_t crc32_queue_submit(const crc32_job *job)
+{
+    bool wasLocked = crc32_queue_port_lock();
+    bool idle = nextHandle - 1 == completed;
+    uint32_t handle = 0;
+
+    /* Idle DMA: nothing will chain this one, start it here once the module
+     * is ours */
+    if (nextHandle - 1 - completed < CRC32_QUEUE_DEPTH &&
+        (!idle || crc32_queue_port_acquire()))
+    {
+        handle = nextHandle++;
+        slotOf(handle)->job = *job;
+
+        if (idle)
+            crc32_queue_port_start(job);
+    }
+
+    crc32_queue_port_unlock(wasLocked);
+    return handle;
+}
+
+bool crc32_queue_done(uint32_t handle)
+{
+    return (int32_t)(completed - handle) >= 0;
+}
+
+uint32_t crc32_queue_wait(uint32_t handle)
+{
+    bool wasLocked = crc32_queue_port_lock();
+
+    while (!crc32_queue_done(handle))
+        crc32_queue_port_sleep();
+
+    crc32_queue_port_unlock(wasLocked);
+    return slotOf(handle)->result;
+}
+
+uint32_t crc32_queue_pending(void)
+{
+    return nextHandle - 1 - completed;
+}
+
+/* From the completion interrupt: finish the running job, start the next */
+void crc32_queue_complete(void)
+{
+    uint32_t handle = completed + 1;
+    crc32_queue_slot *slot = slotOf(handle);
+
+    /* Not ours: the queue is idle */
+    if (nextHandle - 1 == completed)
+        return;
+
+    slot->result = crc32_queue_port_result();
+    completed = handle;
+
+    /* Drained: hand the module back before the callback, which may
+     * submit again */
+    if (handle + 1 != nextHandle)
+        crc32_queue_port_start(&slotOf(handle + 1)->job);
+    else
+        crc32_queue_port_release();
+
+    if (slot->job.callback)
+        slot->job.callback(handle, slot->result, slot->job.arg);
+}
+
+#if defined(__MSP432P401R__)
+bool crc32_queue_port_acquire(void)
+{
+    if (!crc32_arbiter_acquire(slots))
+        return false;
+
+    /* Completions are the queue's only while it owns the module */
+    crc32_dma_on_complete(crc32_queue_complete);
+    return true;
+}
+
+void crc32_queue_port_release(void)
+{
+    crc32_dma_on_complete(0);
+    crc32_arbiter_release(slots);
+}
+
+void crc32_queue_port_start(const crc32_job *job)
+{
+    crc32_hw_restore(job->seed);
+
+    /* Nothing to transfer: an empty word transfer completes through the
+     * interrupt like the rest */
+    if (job->length == 0)
+    {
+        crc32_dma_start_words(job->data, 0);
+    }
+    else
+    {
+        switch (job->type)
+        {
+        case CRC32_JOB_BYTES:
+            crc32_dma_start(job->data, job->length);
+            break;
+        case CRC32_JOB_WORDS:
+            crc32_dma_start_words(job->data, job->length);
+            break;
+        case CRC32_JOB_PINGPONG:
+            crc32_dma_start_pingpong(job->data, job->length);
+            break;
+        case CRC32_JOB_TASKS:
+            crc32_dma_start_tasks(job->data, job->length);
+            break;
+        }
+    }
+}
+
+uint32_t crc32_queue_port_result(void)
+{
+    return crc32_hw_save();
+}
+
+bool crc32_queue_port_lock(void)
+{
+    return MAP_Interrupt_disableMaster();
+}
+
+void crc32_queue_port_unlock(bool wasLocked)
+{
+    if (!wasLocked)
+        MAP_Interrupt_enableMaster();
+}
+
+/* Called with interrupts masked: WFI still wakes on the pending DMA
+ * interrupt, which runs once they are unmasked; see crc32_boot_wait() */
+void crc32_queue_port_sleep(void)
+{
+    MAP_PCM_gotoLPM0();
+    MAP_Interrupt_enableMaster();
+    MAP_Interrupt_disableMaster();
+}
+#endif
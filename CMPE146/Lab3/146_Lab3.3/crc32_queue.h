@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Asynchronous CRC32 DMA job queue
+ *
+ * crc32_queue_submit() copies a job descriptor into a fixed ring and returns
+ * a handle at once. Jobs run one after another through crc32_dma.h; when one
+ * finishes, the DMA completion interrupt saves its CRC32 register, starts the
+ * next queued job and only then calls the finished job's callback, so there
+ * is no gap between chained transfers even if the callback is slow. A
+ * callback may submit further jobs.
+ *
+ * Jobs complete in submission order, so a handle is done once the completion
+ * count has reached it. crc32_queue_wait() sleeps in LPM0 until then instead
+ * of spinning on dma_done.
+ *
+ * The queue claims the CRC32 module through crc32_arbiter.h when its first
+ * job starts and hands it back once the last queued job has completed, so
+ * crc32() and the dispatcher fall back to software meanwhile instead of
+ * reseeding the module under a running job. If another client owns the
+ * module when the queue is idle, crc32_queue_submit() fails. The queue
+ * itself only talks to the DMA and the arbiter through the port functions
+ * below; on the device they are implemented in crc32_queue.c on
+ * top of crc32_dma.h, on the host a simulator provides them
+ * (tools/crc32_queue_check.c).
+ ******************************************************************************/
+#ifndef CRC32_QUEUE_H_
+#define CRC32_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_QUEUE_DEPTH       8
+
+typedef enum
+{
+    CRC32_JOB_BYTES,            /* crc32_dma_start() */
+    CRC32_JOB_WORDS,            /* crc32_dma_start_words() */
+    CRC32_JOB_PINGPONG,         /* crc32_dma_start_pingpong() */
+    CRC32_JOB_TASKS             /* crc32_dma_start_tasks(), data is the task list */
+} crc32_job_type;
+
+/* Called from the DMA interrupt with the raw CRC32 register after the job,
+ * continuing the seed like crc32_dma_update(); ~result is the standard CRC32
+ * for a CRC32_INIT seed */
+typedef void (*crc32_job_callback)(uint32_t handle, uint32_t result, void *arg);
+
+typedef struct
+{
+    crc32_job_type type;
+    const void *data;
+    uint32_t length;            /* bytes, or task count for CRC32_JOB_TASKS */
+    uint32_t seed;              /* raw register value, CRC32_INIT for a new CRC */
+    crc32_job_callback callback;        /* may be NULL */
+    void *arg;
+} crc32_job;
+
+/* Empty the queue. The DMA completion interrupt is hooked only while jobs
+ * are queued, so other crc32_dma users are left alone when it is idle. */
+void crc32_queue_init(void);
+
+/* Queue a job, starting it if the DMA is idle. Returns its handle, or 0 if
+ * the queue is full or idle with the CRC32 module owned by another client.
+ * Safe to call from a callback. */
+uint32_t crc32_queue_submit(const crc32_job *job);
+
+bool crc32_queue_done(uint32_t handle);
+
+/* Sleep until the job has completed; returns its result */
+uint32_t crc32_queue_wait(uint32_t handle);
+
+/* Jobs queued or running */
+uint32_t crc32_queue_pending(void);
+
+/* Port: claim and hand back the CRC32 module, start a job, read the raw
+ * result of the finished one, mask and unmask interrupts, and sleep until
+ * the next interrupt with them masked.
+ * The port calls crc32_queue_complete() from its completion interrupt, once
+ * per job, even for jobs that had nothing to transfer; a call while the
+ * queue is idle is ignored. */
+bool crc32_queue_port_acquire(void);
+void crc32_queue_port_release(void);
+void crc32_queue_port_start(const crc32_job *job);
+uint32_t crc32_queue_port_result(void);
+bool crc32_queue_port_lock(void);
+void crc32_queue_port_unlock(bool wasLocked);
+void crc32_queue_port_sleep(void);
+void crc32_queue_complete(void);
+
+#endif /* CRC32_QUEUE_H_ */
@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Background flash scrubber
+ *
+ * The running CRC of the current region lives in regionCrc between chunks;
+ * it is restored into the CRC32 module before each chunk and saved after, so
+ * other clients can use the module in between. Chunks are word-aligned
+ * multiples of 4 bytes, so the word-wide DMA path needs no byte tail.
+ ******************************************************************************/
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#include <string.h>
+
+#include "crc32_scrub.h"
+#include "crc32_engine.h"
+#include "crc32_hw.h"
+#include "crc32_dma.h"
+#include "crc32_arbiter.h"
+
+static crc32_scrub_region regions[CRC32_SCRUB_REGIONS];
+static uint32_t position;
+static uint32_t regionCrc;
+static uint32_t passes;
+
+void crc32_scrub_init(void)
+{
+    memset(regions, 0, sizeof(regions));
+    position = CRC32_SCRUB_BASE;
+    regionCrc = CRC32_INIT;
+    passes = 0;
+}
+
+static void regionDone(uint32_t index)
+{
+    crc32_scrub_region *region = &regions[index];
+    uint32_t crc = ~regionCrc;
+
+    if (region->passes == 0)
+        region->reference = crc;
+    else if (crc != region->reference)
+        region->mismatches++;
+
+    region->last = crc;
+    region->passes++;
+    regionCrc = CRC32_INIT;
+}
+
+void crc32_scrub_idle(void)
+{
+    uint32_t offset;
+    uint32_t arbitration;
+    bool highPriority;
+
+    if (!crc32_arbiter_acquire(regions))
+    {
+        MAP_PCM_gotoLPM0();
+        return;
+    }
+
+    /* Yield to every other channel after each word, then put back whatever
+     * the CRC32 client had configured */
+    crc32_dma_get_arbitration(&arbitration, &highPriority);
+    crc32_hw_restore(regionCrc);
+    crc32_dma_set_arbitration(UDMA_ARB_1, false);
+    crc32_dma_start_words((const uint8_t *)position, CRC32_SCRUB_CHUNK);
+
+    /* Sleep until the chunk is done; see crc32_boot_wait() for the masking */
+    MAP_Interrupt_disableMaster();
+    while (dma_done != 1)
+    {
+        MAP_PCM_gotoLPM0();
+        MAP_Interrupt_enableMaster();
+        MAP_Interrupt_disableMaster();
+    }
+    MAP_Interrupt_enableMaster();
+
+    crc32_dma_set_arbitration(arbitration, highPriority);
+    regionCrc = crc32_hw_save();
+    crc32_arbiter_release(regions);
+
+    position += CRC32_SCRUB_CHUNK;
+    offset = position - CRC32_SCRUB_BASE;
+    if (offset % CRC32_SCRUB_REGION_SIZE == 0)
+        regionDone(offset / CRC32_SCRUB_REGION_SIZE - 1);
+
+    if (position >= CRC32_SCRUB_BASE + CRC32_SCRUB_SIZE)
+    {
+        position = CRC32_SCRUB_BASE;
+        passes++;
+    }
+}
+
+uint32_t crc32_scrub_position(void)
+{
+    return position;
+}
+
+uint32_t crc32_scrub_passes(void)
+{
+    return passes;
+}
+
+const crc32_scrub_region *crc32_scrub_regions(void)
+{
+    return regions;
+}
+
+bool crc32_scrub_region_ok(uint32_t region)
+{
+    return region < CRC32_SCRUB_REGIONS && regions[region].passes >= 2 &&
+           regions[region].mismatches == 0;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Background flash scrubber
+ *
+ * Continuously CRCs MAIN flash (0x00000000 - 0x0003FFFF) region by region
+ * without stalling the application. The application calls crc32_scrub_idle()
+ * wherever it would otherwise call MAP_PCM_gotoLPM0(); each call feeds one
+ * small chunk to the CRC32 module by DMA, at the lowest arbitration setting
+ * (rearbitrate after every item, normal priority), and sleeps in LPM0 until
+ * it is done. The foreground therefore never waits for more than one chunk
+ * and never finds a scrub transfer in flight.
+ *
+ * The first complete pass over a region records its reference CRC; every
+ * later pass is compared against it. Regions are 4 KiB flash sectors.
+ *
+ * Uses DMA channel 0 (see crc32_dma.h) and claims the CRC32 module through
+ * crc32_arbiter.h; if another client owns the module, the idle call just
+ * sleeps.
+ ******************************************************************************/
+#ifndef CRC32_SCRUB_H_
+#define CRC32_SCRUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRC32_SCRUB_BASE        0x00000000
+#define CRC32_SCRUB_SIZE        0x00040000
+#define CRC32_SCRUB_REGION_SIZE 4096
+#define CRC32_SCRUB_CHUNK       256
+#define CRC32_SCRUB_REGIONS     (CRC32_SCRUB_SIZE / CRC32_SCRUB_REGION_SIZE)
+
+typedef struct
+{
+    uint32_t reference;         /* CRC32 of the first complete pass */
+    uint32_t last;              /* CRC32 of the latest complete pass */
+    uint32_t passes;
+    uint32_t mismatches;        /* passes that did not match the reference */
+} crc32_scrub_region;
+
+/* Start over at CRC32_SCRUB_BASE and forget all results */
+void crc32_scrub_init(void);
+
+/* Scrub one chunk, then sleep; use in place of MAP_PCM_gotoLPM0() */
+void crc32_scrub_idle(void);
+
+/* Address of the next chunk */
+uint32_t crc32_scrub_position(void);
+
+/* Completed passes over the whole flash */
+uint32_t crc32_scrub_passes(void);
+
+/* Per-region results, CRC32_SCRUB_REGIONS entries */
+const crc32_scrub_region *crc32_scrub_regions(void);
+
+/* Region has been checked at least twice and never mismatched */
+bool crc32_scrub_region_ok(uint32_t region);
+
+#endif /* CRC32_SCRUB_H_ */
@@ -0,0 +1,48 @@
+/*******************************************************************************
+ * Scatter-gather CRC32 over DMA
+ *
+ * Byte source, incrementing; fixed destination; one arbitration burst of up
+ * to 1024 items per task, so a task is never interrupted by rearbitration.
+ ******************************************************************************/
+#include "crc32_sg.h"
+
+uint32_t crc32_sg_build(const crc32_sg_fragment *fragments, uint32_t count,
+                        volatile void *destination, crc32_sg_task *tasks, uint32_t maxTasks)
+{
+    uint32_t taskCount = 0;
+    uint32_t ii;
+
+    if (maxTasks > CRC32_SG_MAX_TASKS)
+        maxTasks = CRC32_SG_MAX_TASKS;
+
+    for (ii = 0; ii < count; ii++)
+    {
+        const uint8_t *data = fragments[ii].data;
+        uint32_t length = fragments[ii].length;
+
+        while (length)
+        {
+            uint32_t items = length > 1024 ? 1024 : length;
+
+            if (taskCount == maxTasks)
+                return 0;
+
+            tasks[taskCount].srcEnd = data + items - 1;
+            tasks[taskCount].dstEnd = destination;
+            tasks[taskCount].control = CRC32_SG_DST_INC_NONE | CRC32_SG_ARB_1024 |
+                                       ((items - 1) << CRC32_SG_COUNT_SHIFT) |
+                                       CRC32_SG_MODE_MEM_ALT;
+            tasks[taskCount].spare = 0;
+            taskCount++;
+
+            data += items;
+            length -= items;
+        }
+    }
+
+    if (taskCount)
+        tasks[taskCount - 1].control = (tasks[taskCount - 1].control & ~CRC32_SG_MODE_MASK) |
+                                       CRC32_SG_MODE_AUTO;
+
+    return taskCount;
+}
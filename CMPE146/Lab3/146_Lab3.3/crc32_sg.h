@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * Scatter-gather CRC32 over DMA
+ *
+ * Turns a list of (pointer, length) fragments, e.g. the header, payload and
+ * trailer of a packet, into a uDMA memory scatter-gather task list. Started
+ * with crc32_dma_start_tasks(), the whole list feeds the CRC32 module in one
+ * software request: the primary control structure of channel 0 copies each
+ * task into the alternate structure, which moves its bytes, with no CPU
+ * involvement until the single completion interrupt after the last task.
+ *
+ * A task moves at most 1024 bytes, so longer fragments take several tasks;
+ * empty fragments take none. The last task is an auto transfer, which ends
+ * the chain; all others are memory scatter-gather (alternate) tasks.
+ *
+ * The builder only fills memory and builds for the host as well; the task
+ * list must stay valid until dma_done is set.
+ ******************************************************************************/
+#ifndef CRC32_SG_H_
+#define CRC32_SG_H_
+
+#include <stdint.h>
+
+/* The primary structure copies the list 4 words per task, at most 1024 words */
+#define CRC32_SG_MAX_TASKS      256
+
+typedef struct
+{
+    const void *data;
+    uint32_t length;
+} crc32_sg_fragment;
+
+/* One uDMA control structure: same layout as a control table entry */
+typedef struct
+{
+    volatile const void *srcEnd;        /* last source byte */
+    volatile void *dstEnd;              /* fixed destination register */
+    uint32_t control;
+    uint32_t spare;
+} crc32_sg_task;
+
+/* Control word fields (PL230 channel_cfg), as in driverlib's UDMA_ values */
+#define CRC32_SG_DST_INC_NONE   0xC0000000
+#define CRC32_SG_ARB_1024       (10u << 14)
+#define CRC32_SG_COUNT_SHIFT    4
+#define CRC32_SG_COUNT_MASK     (0x3FFu << CRC32_SG_COUNT_SHIFT)
+#define CRC32_SG_MODE_MASK      0x7
+#define CRC32_SG_MODE_AUTO      0x2
+#define CRC32_SG_MODE_MEM_ALT   0x5
+
+/*
+ * Build the task list for byte transfers of every fragment to destination
+ * (&CRC32->DI32 on the device). Returns the number of tasks, or 0 if the
+ * fragments are empty or need more than maxTasks (or CRC32_SG_MAX_TASKS).
+ */
+uint32_t crc32_sg_build(const crc32_sg_fragment *fragments, uint32_t count,
+                        volatile void *destination, crc32_sg_task *tasks, uint32_t maxTasks);
+
+#endif /* CRC32_SG_H_ */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * CRC32 lookup tables
+ *
+ * The tables are generated by the preprocessor at build time. CRC is linear,
+ * so every table entry is the XOR of the entries for the single bits set in
+ * its index, and for the reflected polynomial those single-bit entries are
+ * all points on one chain: x(0) = 1, x(m) = x(m-1) shifted once through the
+ * polynomial. The chain is built as enumeration constants (split into 16-bit
+ * halves so each value is a valid int), which keeps the expansion linear in
+ * size and lets the compiler fold every table into plain const data. The TI
+ * linker command file places .const in MAIN flash, so none of the tables
+ * costs SRAM or startup time.
+ *
+ * Which tables exist depends on CRC32_TABLE_TIER (see crc32_engine.h):
+ *
+ *     CRC32_TIER_NIBBLE    crc32NibbleTable[16]        64 B
+ *     CRC32_TIER_BYTE      crc32Table[1][256]          1 KiB   (+ nibble)
+ *     CRC32_TIER_SLICE8    crc32Table[8][256]          8 KiB   (+ nibble)
+ *
+ * This header defines the tables and must only be included by crc32_engine.c.
+ ******************************************************************************/
+#ifndef CRC32_TABLES_H_
+#define CRC32_TABLES_H_
+
+#include "crc32_engine.h"
+
+/* One shift of the CRC register, high and low half */
+#define CRC32_STEP_HI(h, l)     (((h) >> 1) ^ (((l) & 1) ? (CRC32_POLY >> 16) : 0))
+#define CRC32_STEP_LO(h, l)     ((((l) >> 1) | (((h) & 1) << 15)) ^ \
+                                 (((l) & 1) ? (CRC32_POLY & 0xFFFF) : 0))
+
+#define CRC32_LINK(n, p)        CRC32_H##n = CRC32_STEP_HI(CRC32_H##p, CRC32_L##p), \
+                                CRC32_L##n = CRC32_STEP_LO(CRC32_H##p, CRC32_L##p)
+
+enum
+{
+    CRC32_H0 = 0, CRC32_L0 = 1,
+    CRC32_LINK(1, 0), CRC32_LINK(2, 1), CRC32_LINK(3, 2), CRC32_LINK(4, 3),
+    CRC32_LINK(5, 4), CRC32_LINK(6, 5), CRC32_LINK(7, 6), CRC32_LINK(8, 7),
+    CRC32_LINK(9, 8), CRC32_LINK(10, 9), CRC32_LINK(11, 10), CRC32_LINK(12, 11),
+    CRC32_LINK(13, 12), CRC32_LINK(14, 13), CRC32_LINK(15, 14), CRC32_LINK(16, 15),
+    CRC32_LINK(17, 16), CRC32_LINK(18, 17), CRC32_LINK(19, 18), CRC32_LINK(20, 19),
+    CRC32_LINK(21, 20), CRC32_LINK(22, 21), CRC32_LINK(23, 22), CRC32_LINK(24, 23),
+    CRC32_LINK(25, 24), CRC32_LINK(26, 25), CRC32_LINK(27, 26), CRC32_LINK(28, 27),
+    CRC32_LINK(29, 28), CRC32_LINK(30, 29), CRC32_LINK(31, 30), CRC32_LINK(32, 31),
+    CRC32_LINK(33, 32), CRC32_LINK(34, 33), CRC32_LINK(35, 34), CRC32_LINK(36, 35),
+    CRC32_LINK(37, 36), CRC32_LINK(38, 37), CRC32_LINK(39, 38), CRC32_LINK(40, 39),
+    CRC32_LINK(41, 40), CRC32_LINK(42, 41), CRC32_LINK(43, 42), CRC32_LINK(44, 43),
+    CRC32_LINK(45, 44), CRC32_LINK(46, 45), CRC32_LINK(47, 46), CRC32_LINK(48, 47),
+    CRC32_LINK(49, 48), CRC32_LINK(50, 49), CRC32_LINK(51, 50), CRC32_LINK(52, 51),
+    CRC32_LINK(53, 52), CRC32_LINK(54, 53), CRC32_LINK(55, 54), CRC32_LINK(56, 55),
+    CRC32_LINK(57, 56), CRC32_LINK(58, 57), CRC32_LINK(59, 58), CRC32_LINK(60, 59),
+    CRC32_LINK(61, 60), CRC32_LINK(62, 61), CRC32_LINK(63, 62), CRC32_LINK(64, 63)
+};
+
+#define CRC32_X(m)              (((uint32_t)CRC32_H##m << 16) | (uint32_t)CRC32_L##m)
+#define CRC32_BIT(n, i, x)      ((((n) >> (i)) & 1) ? (x) : 0)
+
+/* Nibble entry n (4 register shifts) uses x(4-i) for bit i */
+#define CRC32_N(n)              (CRC32_BIT(n, 0, CRC32_X(4)) ^ CRC32_BIT(n, 1, CRC32_X(3)) ^ \
+                                 CRC32_BIT(n, 2, CRC32_X(2)) ^ CRC32_BIT(n, 3, CRC32_X(1)))
+
+/* Table entry n for a byte followed by k zero bytes uses x(8(k+1)-i) for bit i */
+#define CRC32_ENTRY(n, a, b, c, d, e, f, g, h) \
+    (CRC32_BIT(n, 0, CRC32_X(a)) ^ CRC32_BIT(n, 1, CRC32_X(b)) ^ \
+     CRC32_BIT(n, 2, CRC32_X(c)) ^ CRC32_BIT(n, 3, CRC32_X(d)) ^ \
+     CRC32_BIT(n, 4, CRC32_X(e)) ^ CRC32_BIT(n, 5, CRC32_X(f)) ^ \
+     CRC32_BIT(n, 6, CRC32_X(g)) ^ CRC32_BIT(n, 7, CRC32_X(h)))
+
+#define CRC32_T0(n)             CRC32_ENTRY(n, 8, 7, 6, 5, 4, 3, 2, 1)
+#define CRC32_T1(n)             CRC32_ENTRY(n, 16, 15, 14, 13, 12, 11, 10, 9)
+#define CRC32_T2(n)             CRC32_ENTRY(n, 24, 23, 22, 21, 20, 19, 18, 17)
+#define CRC32_T3(n)             CRC32_ENTRY(n, 32, 31, 30, 29, 28, 27, 26, 25)
+#define CRC32_T4(n)             CRC32_ENTRY(n, 40, 39, 38, 37, 36, 35, 34, 33)
+#define CRC32_T5(n)             CRC32_ENTRY(n, 48, 47, 46, 45, 44, 43, 42, 41)
+#define CRC32_T6(n)             CRC32_ENTRY(n, 56, 55, 54, 53, 52, 51, 50, 49)
+#define CRC32_T7(n)             CRC32_ENTRY(n, 64, 63, 62, 61, 60, 59, 58, 57)
+
+#define CRC32_ROW4(t, n)        t(n), t((n) + 1), t((n) + 2), t((n) + 3)
+#define CRC32_ROW16(t, n)       CRC32_ROW4(t, n), CRC32_ROW4(t, (n) + 4), \
+                                CRC32_ROW4(t, (n) + 8), CRC32_ROW4(t, (n) + 12)
+#define CRC32_ROW64(t, n)       CRC32_ROW16(t, n), CRC32_ROW16(t, (n) + 16), \
+                                CRC32_ROW16(t, (n) + 32), CRC32_ROW16(t, (n) + 48)
+#define CRC32_TABLE(t)          { CRC32_ROW64(t, 0), CRC32_ROW64(t, 64), \
+                                  CRC32_ROW64(t, 128), CRC32_ROW64(t, 192) }
+
+/* crc32NibbleTable[n]: CRC register contribution of the 4-bit value n */
+static const uint32_t crc32NibbleTable[16] = { CRC32_ROW16(CRC32_N, 0) };
+
+#if CRC32_TABLE_TIER == CRC32_TIER_SLICE8
+#define CRC32_TABLE_SLICES      8
+#elif CRC32_TABLE_TIER == CRC32_TIER_BYTE
+#define CRC32_TABLE_SLICES      1
+#endif
+
+#ifdef CRC32_TABLE_SLICES
+/* crc32Table[k][n]: CRC register contribution of byte n followed by k zero bytes */
+static const uint32_t crc32Table[CRC32_TABLE_SLICES][256] =
+{
+    CRC32_TABLE(CRC32_T0),
+#if CRC32_TABLE_SLICES == 8
+    CRC32_TABLE(CRC32_T1), CRC32_TABLE(CRC32_T2), CRC32_TABLE(CRC32_T3),
+    CRC32_TABLE(CRC32_T4), CRC32_TABLE(CRC32_T5), CRC32_TABLE(CRC32_T6),
+    CRC32_TABLE(CRC32_T7)
+#endif
+};
+#endif
+
+#endif /* CRC32_TABLES_H_ */
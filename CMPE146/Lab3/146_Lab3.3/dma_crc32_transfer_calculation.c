@@ -61,28 +61,42 @@
 #include <string.h>
 #include <stdbool.h>
 
+#include "crc32_engine.h"
+#include "crc32_hw.h"
+#include "crc32_dma.h"
+#include "crc32_dispatch.h"
+#include "crc32_arbiter.h"
+#include "crc32_boot.h"
+#include "crc32_scrub.h"
+#include "crc32_sg.h"
+#include "crc32_queue.h"
+#include "dma_manager.h"
+
 #define CRC32_SEED              0xFFFFFFFF
 
 /* Statics */
 static volatile uint32_t crcSignature;
 
-/* DMA Control Table */
-#if defined(__TI_COMPILER_VERSION__)
-#pragma DATA_ALIGN(controlTable, 1024)
-#elif defined(__IAR_SYSTEMS_ICC__)
-#pragma data_alignment=1024
-#elif defined(__GNUC__)
-__attribute__ ((aligned (1024)))
-#elif defined(__CC_ARM)
-__align(1024)
-#endif
-uint8_t controlTable[1024];
+/* DMA clients and their channels */
+static const dma_client dmaClients[] = {
+    {"CRC32", DMA_CH0_RESERVED0, false, false, crc32_dma_interrupt},
+};
 
 uint8_t data_array[10240];
 
+/* Task list for the scatter-gather packet CRC */
+static crc32_sg_task packetTasks[8];
+
 int size;
 int size_array[] = {512, 1024, 1030, 1824, 2048, 2049, 2303, 10240};
-volatile int dma_done;
+
+/* CRCs of the queued quarters of data_array, filled in by the callback */
+static uint32_t quarterCRCs[4];
+
+/* Share of a hybrid CRC fed through DMA, in 1/65536 of the buffer */
+uint32_t hybridDmaShare = 32768;
+
+const char *backendNames[CRC32_BACKEND_COUNT] = {"software", "CRC32 module", "DMA"};
 
 void startTimer() {
     /* Setup counter */
@@ -106,29 +120,119 @@ uint32_t computeElapsedTimeInMicroseconds(const uint32_t t0, const uint32_t t1)
     return elapsedTimeInMicroseconds;
 }
 
+void quarterDone(uint32_t handle, uint32_t result, void *arg) {
+    *(uint32_t *)arg = ~result;
+}
+
+/*
+ * Hybrid CRC32: the DMA feeds the CRC32 module with the first part of the
+ * buffer while the CPU runs the table-driven software CRC over the rest. The
+ * two partial CRCs are merged with crc32_combine(). Returns the standard
+ * (inverted) CRC32 of the whole buffer.
+ */
+uint32_t hybridCRC32(const uint8_t *data, int length) {
+    int dmaLength = ((uint32_t)length * hybridDmaShare) >> 16;
+
+    if (dmaLength == 0)
+        return ~crc32_update(CRC32_INIT, data, length);
+
+    MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+    crc32_dma_start(data, dmaLength);
+
+    uint32_t swCRC = ~crc32_update(CRC32_INIT, data + dmaLength, length - dmaLength);
+
+    while(dma_done != 1);
+
+    return crc32_combine(~crc32_hw_save(), swCRC, length - dmaLength);
+}
+
+/*
+ * Balance the hybrid split so both engines finish together: with per-byte
+ * times tDMA and tSW the DMA share is tSW / (tDMA + tSW). Both are measured
+ * over the largest block.
+ */
+void calibrateHybridSplit(const uint8_t *data, int length) {
+    uint32_t t0 = getTimerValue();
+    MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+    crc32_dma_start(data, length);
+    while(dma_done != 1);
+    uint32_t t1 = getTimerValue();
+    crc32_update(CRC32_INIT, data, length);
+    uint32_t t2 = getTimerValue();
+
+    uint32_t dmaTicks = t0 - t1;
+    uint32_t swTicks = t1 - t2;
+
+    hybridDmaShare = (uint32_t)(((uint64_t)swTicks << 16) / (dmaTicks + swTicks));
+    printf("\nHybrid split: %u/65536 of each block through DMA\n", hybridDmaShare);
+}
+
 int main(void)
 {
+    int i;
+
     /* Halting Watchdog */
     MAP_WDT_A_holdTimer();
 
+    /* Configuring DMA module: one entry per DMA client */
+    uint32_t failedClient;
+    if (dma_manager_init(dmaClients, sizeof(dmaClients)/sizeof(dmaClients[0]),
+                         &failedClient) != DMA_MANAGER_OK) {
+        printf("\nDMA channel conflict: %s\n", dmaClients[failedClient].name);
+        while (1);
+    }
+
+    /* Enabling Interrupts */
+    MAP_Interrupt_enableMaster();
+
+    crc32_arbiter_init();
+
+    /* Check the image in the background while the rest is set up */
+    bool bootStarted = crc32_boot_start();
+
     startTimer();
 
-    /* Configuring DMA module */
-    MAP_DMA_enableModule();
-    MAP_DMA_setControlBase(controlTable);
+    /* Test pattern for the benchmarks below */
+    for (i = 0; i < sizeof(data_array); i++) {
+        data_array[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
 
-    /* Assigning/Enabling Interrupts */
-    MAP_DMA_assignInterrupt(DMA_INT1, 0);
-    MAP_Interrupt_enableInterrupt(INT_DMA_INT1);
-    MAP_Interrupt_enableMaster();
+    /* Fixed packet layout for the scatter-gather demo */
+    crc32_sg_fragment packet[] = {
+        {data_array, 14},
+        {data_array + 4096, 1500},
+        {data_array + 9000, 4},
+    };
+    uint32_t taskCount = crc32_sg_build(packet, sizeof(packet)/sizeof(packet[0]), &CRC32->DI32,
+                                        packetTasks, sizeof(packetTasks)/sizeof(packetTasks[0]));
+
+    bool imageOk = crc32_boot_wait();
+    uint32_t sectionCount;
+    const crc32_boot_section *sections = crc32_boot_sections(&sectionCount);
+
+    if (!bootStarted) {
+        printf("\nImage check: FAILED, CRC32 module busy\n");
+    } else if (crc32_boot_records() > sectionCount) {
+        printf("\nImage check: FAILED, only %u of %u sections checked\n",
+               sectionCount, crc32_boot_records());
+    } else {
+        printf("\nImage check: %s\n", imageOk ? "passed" : "FAILED");
+    }
+    for (i = 0; i < sectionCount; i++) {
+        printf("  %08x %6u bytes: %s, %u cycles\n", sections[i].addr, sections[i].size,
+               sections[i].status == CRC32_BOOT_PASS ? "ok" :
+               sections[i].status == CRC32_BOOT_FAIL ? "BAD" : "skipped",
+               sections[i].cycles);
+    }
 
-    /* Setting Control Indexes. In this case we will set the source of the
-             * DMA transfer to our random data array and the destination to the
-             * CRC32 data in register address*/
-    MAP_DMA_setChannelControl(UDMA_PRI_SELECT,
-                              UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1024);
+    calibrateHybridSplit(data_array, sizeof(data_array));
+
+    crc32_crossover crossover;
+    crc32_dispatch_calibrate(data_array, sizeof(data_array));
+    crc32_dispatch_get(&crossover);
+    printf("\nDispatch crossover: CRC32 module from %u bytes, DMA from %u bytes\n",
+           crossover.hwMin, crossover.dmaMin);
 
-    int i;
     for (i = 0; i < sizeof(size_array)/sizeof(size_array[0]); i++) {
         size = size_array[i];
         printf("\nBlock Size: %i\n", size);
@@ -154,24 +258,11 @@ int main(void)
 
         //  DMA
 
-        int transferSize = size > 1024 ? 1024 : size;
-        MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT,
-                                   UDMA_MODE_AUTO,
-                                   data_array,
-                                   (void*) (&CRC32->DI32),
-                                   transferSize);
-
         uint32_t dma_t0 = getTimerValue();
 
-        /* Enabling DMA Channel 0 */
-        MAP_DMA_enableChannel(0);
-
-        dma_done = 0;
-
         MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
 
-        /* Forcing a software transfer on DMA Channel 0 */
-        MAP_DMA_requestSoftwareTransfer(0);
+        crc32_dma_start(data_array, size);
 
         while(dma_done != 1);
 
@@ -189,43 +280,184 @@ int main(void)
 
         uint32_t dmaSpeedup = (float)hw_elapsedTime/(float)dma_elapsedTime;
         printf("\nSpeedup: %f times faster\n", dmaSpeedup);
+
+        //  PING-PONG
+
+        /* Re-arm per chunk (above) against both control structures in turn */
+        if (size == 2049 || size == 10240) {
+            uint32_t pingpong_t0 = getTimerValue();
+
+            MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+            crc32_dma_start_pingpong(data_array, size);
+            while(dma_done != 1);
+            uint32_t pingpongCRC = MAP_CRC32_getResult(CRC32_MODE);
+
+            uint32_t pingpong_t1 = getTimerValue();
+            uint32_t pingpong_elapsedTime = computeElapsedTimeInMicroseconds(pingpong_t0, pingpong_t1);
+
+            printf("\nPing-pong DMA_CRC = %08x (%s)\n", pingpongCRC,
+                   pingpongCRC == crcSignature ? "match" : "MISMATCH");
+            printf("Ping-pong DMA CRC Elapsed Time: %u us (re-arm %u us, %f times faster)\n",
+                   pingpong_elapsedTime, dma_elapsedTime,
+                   (float)dma_elapsedTime/(float)pingpong_elapsedTime);
+        }
+
+        //  END PING-PONG
+
+        //  HYBRID
+
+        uint32_t hybrid_t0 = getTimerValue();
+
+        uint32_t hybridCRC = hybridCRC32(data_array, size);
+
+        uint32_t hybrid_t1 = getTimerValue();
+        uint32_t hybrid_elapsedTime = computeElapsedTimeInMicroseconds(hybrid_t0, hybrid_t1);
+
+        printf("\nHybrid CRC = %08x (software %08x)\n", hybridCRC, calculateCRC32(data_array, size));
+        printf("Hybrid CRC Elapsed Time: %u us\n", hybrid_elapsedTime);
+        printf("Hybrid speedup over DMA: %f times faster\n", (float)dma_elapsedTime/(float)hybrid_elapsedTime);
+
+        //  END HYBRID
+
+        //  WORD-WIDE
+
+        uint32_t hw32_t0 = getTimerValue();
+
+        MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+        crc32_hw_feed(data_array, size);
+        uint32_t hw32CRC = MAP_CRC32_getResult(CRC32_MODE);
+
+        uint32_t hw32_t1 = getTimerValue();
+        uint32_t hw32_elapsedTime = computeElapsedTimeInMicroseconds(hw32_t0, hw32_t1);
+
+        uint32_t dma32_t0 = getTimerValue();
+
+        MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+        crc32_dma_start_words(data_array, size);
+        while(dma_done != 1);
+        uint32_t dma32CRC = MAP_CRC32_getResult(CRC32_MODE);
+
+        uint32_t dma32_t1 = getTimerValue();
+        uint32_t dma32_elapsedTime = computeElapsedTimeInMicroseconds(dma32_t0, dma32_t1);
+
+        /* Odd start address and length exercise the head and tail paths */
+        MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+        crc32_dma_start_words(data_array + 1, size - 2);
+        while(dma_done != 1);
+        uint32_t unalignedCRC = ~crc32_hw_save();
+
+        printf("\nWord hwCRC = %08x (%s), Word DMA_CRC = %08x (%s), unaligned %s\n",
+               hw32CRC, hw32CRC == hwCRC ? "match" : "MISMATCH",
+               dma32CRC, dma32CRC == crcSignature ? "match" : "MISMATCH",
+               unalignedCRC == calculateCRC32(data_array + 1, size - 2) ? "match" : "MISMATCH");
+        printf("Word Hardware CRC Elapsed Time: %u us (%f times faster than bytes)\n",
+               hw32_elapsedTime, (float)hw_elapsedTime/(float)hw32_elapsedTime);
+        printf("Word DMA CRC Elapsed Time: %u us (%f times faster than bytes)\n",
+               dma32_elapsedTime, (float)dma_elapsedTime/(float)dma32_elapsedTime);
+
+        //  END WORD-WIDE
+
+        //  DISPATCH
+
+        uint32_t dispatch_t0 = getTimerValue();
+
+        uint32_t dispatchCRC = crc32(data_array, size);
+
+        uint32_t dispatch_t1 = getTimerValue();
+        uint32_t dispatch_elapsedTime = computeElapsedTimeInMicroseconds(dispatch_t0, dispatch_t1);
+
+        printf("\nDispatched CRC = %08x on %s, %u us\n", dispatchCRC,
+               backendNames[crc32_dispatch_select(size)], dispatch_elapsedTime);
+
+        //  END DISPATCH
+
         printf("\n--------------------------------------\n");
     }
-}
 
-/* Completion interrupt for DMA */
-void DMA_INT1_IRQHandler(void)
-{
-    MAP_DMA_disableChannel(0);
-    size -= 1024;
+    //  SCATTER-GATHER
+
+    /* Header, payload and trailer in separate buffers, one DMA request; the
+     * task list was built during the image check */
+    uint32_t sg_t0 = getTimerValue();
 
-    if (size > 1024) {
-        MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT,
-                                   UDMA_MODE_AUTO,
-                                   data_array,
-                                   (void*) (&CRC32->DI32),
-                                   1024);
+    MAP_CRC32_setSeed(CRC32_SEED, CRC32_MODE);
+    crc32_dma_start_tasks(packetTasks, taskCount);
+    while(dma_done != 1);
+    uint32_t sgCRC = ~crc32_hw_save();
 
-        /* Enabling DMA Channel 0 */
-        MAP_DMA_enableChannel(0);
+    uint32_t sg_t1 = getTimerValue();
 
-        /* Forcing a software transfer on DMA Channel 0 */
-        MAP_DMA_requestSoftwareTransfer(0);
+    uint32_t packetCRC = CRC32_INIT;
+    for (i = 0; i < sizeof(packet)/sizeof(packet[0]); i++)
+        packetCRC = crc32_update(packetCRC, packet[i].data, packet[i].length);
 
-    } else if (size > 0) {
-        MAP_DMA_setChannelTransfer(UDMA_PRI_SELECT,
-                                   UDMA_MODE_AUTO,
-                                   data_array,
-                                   (void*) (&CRC32->DI32),
-                                   size);
+    printf("\nScatter-gather CRC = %08x (%s), %u tasks, %u us\n", sgCRC,
+           sgCRC == ~packetCRC ? "match" : "MISMATCH", taskCount,
+           computeElapsedTimeInMicroseconds(sg_t0, sg_t1));
 
-        /* Enabling DMA Channel 0 */
-        MAP_DMA_enableChannel(0);
+    /* The chain ends on the alternate structure; a basic transfer right
+     * after it must still start from the primary one */
+    uint32_t afterCRC = ~crc32_dma_update(CRC32_INIT, data_array, 2048);
+    printf("Basic DMA after scatter-gather = %08x (%s)\n", afterCRC,
+           afterCRC == calculateCRC32(data_array, 2048) ? "match" : "MISMATCH");
 
-        /* Forcing a software transfer on DMA Channel 0 */
-        MAP_DMA_requestSoftwareTransfer(0);
+    //  END SCATTER-GATHER
 
+    //  JOB QUEUE
+
+    /* Four quarters queued at once: each starts from the interrupt of the
+     * previous one while the CPU sleeps */
+    crc32_queue_init();
+
+    uint32_t queue_t0 = getTimerValue();
+
+    uint32_t quarter = sizeof(data_array) / 4;
+    uint32_t lastHandle = 0;
+    uint32_t queued;
+    for (queued = 0; queued < 4; queued++) {
+        crc32_job job = {CRC32_JOB_WORDS, data_array + queued * quarter, quarter, CRC32_INIT,
+                         quarterDone, &quarterCRCs[queued]};
+        uint32_t handle = crc32_queue_submit(&job);
+
+        /* Rejected: another client has the CRC32 module */
+        if (handle == 0)
+            break;
+        lastHandle = handle;
+    }
+    crc32_queue_wait(lastHandle);
+
+    uint32_t queue_t1 = getTimerValue();
+
+    if (queued < 4) {
+        printf("\nQueued CRC: job %u rejected, CRC32 module busy\n", queued);
     } else {
-        dma_done = 1;
+        uint32_t queueCRC = quarterCRCs[0];
+        for (i = 1; i < 4; i++)
+            queueCRC = crc32_combine(queueCRC, quarterCRCs[i], quarter);
+
+        printf("\nQueued CRC = %08x (%s), %u us\n", queueCRC,
+               queueCRC == calculateCRC32(data_array, sizeof(data_array)) ? "match" : "MISMATCH",
+               computeElapsedTimeInMicroseconds(queue_t0, queue_t1));
+    }
+
+    //  END JOB QUEUE
+
+    const crc32_backend_stats *stats = crc32_dispatch_stats();
+    for (i = 0; i < CRC32_BACKEND_COUNT; i++) {
+        printf("%s: %u calls, %u bytes\n", backendNames[i], stats[i].calls, (uint32_t)stats[i].bytes);
+    }
+
+    const crc32_arbiter_counters *arbiter = crc32_arbiter_stats();
+    printf("CRC32 module: %u grants, %u contentions, longest hold %u cycles, "
+           "longest fallback %u cycles\n", arbiter->grants, arbiter->contentions,
+           arbiter->maxHoldCycles, arbiter->maxFallbackCycles);
+
+    /* Per-channel DMA counters and the last DMA events, in SysTick ticks */
+    dma_manager_dump();
+
+    /* Idle: keep checking MAIN flash in the background */
+    crc32_scrub_init();
+    while (1) {
+        crc32_scrub_idle();
     }
 }
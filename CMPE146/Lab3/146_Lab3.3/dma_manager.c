@@ -0,0 +1,430 @@
+/*******************************************************************************
+ * DMA channel manager
+ *
+ * The control table holds 32 primary and 32 alternate structures, the layout
+ * driverlib indexes with UDMA_PRI_SELECT/UDMA_ALT_SELECT, although only the
+ * first DMA_MANAGER_CHANNELS of each are used.
+ *
+ * SysTick free-runs over its full 24 bits as the time base for the counters;
+ * it counts down, so an interval is (start - end) masked to 24 bits. Counters
+ * and trace are updated with interrupts masked, since clients report from
+ * both thread and interrupt context.
+ ******************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+
+#include "dma_manager.h"
+
+/* DMA Control Table */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(controlTable, 1024)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma data_alignment=1024
+#elif defined(__GNUC__)
+__attribute__ ((aligned (1024)))
+#elif defined(__CC_ARM)
+__align(1024)
+#endif
+static DMA_ControlTable controlTable[64];
+
+static const dma_client *owners[DMA_MANAGER_CHANNELS];
+
+/* Channel on each dedicated line DMA_INT1..DMA_INT3, -1 if unused */
+static int32_t dedicated[3] = {-1, -1, -1};
+
+/* Channels raised by dma_manager_pend() on the shared line */
+static volatile uint32_t softPending;
+
+static dma_channel_counters counters[DMA_MANAGER_CHANNELS];
+
+/* SysTick when each channel's job started and its last cycle was armed */
+static uint32_t jobStarted[DMA_MANAGER_CHANNELS];
+static uint32_t lastArmed[DMA_MANAGER_CHANNELS];
+static bool armed[DMA_MANAGER_CHANNELS];
+
+#if DMA_MANAGER_TRACE_SIZE > 0
+static dma_trace_entry trace[DMA_MANAGER_TRACE_SIZE];
+static uint32_t traceNext;              /* total events recorded */
+#endif
+
+static const uint32_t dedicatedLines[3] = {DMA_INT1, DMA_INT2, DMA_INT3};
+static const uint32_t dedicatedInterrupts[3] = {INT_DMA_INT1, INT_DMA_INT2, INT_DMA_INT3};
+
+#define TICK_MASK   0x00FFFFFF
+
+static uint32_t now(void)
+{
+    return MAP_SysTick_getValue();
+}
+
+static uint32_t elapsed(uint32_t start, uint32_t end)
+{
+    return (start - end) & TICK_MASK;
+}
+
+static void record(uint32_t channel, dma_trace_event event, uint32_t value, uint32_t time)
+{
+#if DMA_MANAGER_TRACE_SIZE > 0
+    dma_trace_entry *entry = &trace[traceNext % DMA_MANAGER_TRACE_SIZE];
+
+    entry->time = time;
+    entry->channel = channel;
+    entry->event = event;
+    entry->value = value > UINT16_MAX ? UINT16_MAX : value;
+    traceNext++;
+#else
+    (void)channel;
+    (void)event;
+    (void)value;
+    (void)time;
+#endif
+}
+
+uint32_t dma_manager_channel(uint32_t mapping)
+{
+    return mapping & 0xFF;
+}
+
+dma_manager_status dma_manager_init(const dma_client *clients, uint32_t count,
+                                    uint32_t *failedClient)
+{
+    const dma_client *claimed[DMA_MANAGER_CHANNELS] = {NULL};
+    bool shared = false;
+    uint32_t lines = 0;
+    uint32_t ii;
+
+    /* Check everything before touching the hardware */
+    for (ii = 0; ii < count; ii++)
+    {
+        uint32_t channel = dma_manager_channel(clients[ii].mapping);
+        dma_manager_status status = DMA_MANAGER_OK;
+
+        if (channel >= DMA_MANAGER_CHANNELS)
+            status = DMA_MANAGER_BAD_CHANNEL;
+        else if (claimed[channel])
+            status = DMA_MANAGER_CHANNEL_TAKEN;
+
+        if (status != DMA_MANAGER_OK)
+        {
+            if (failedClient)
+                *failedClient = ii;
+            return status;
+        }
+
+        claimed[channel] = &clients[ii];
+    }
+
+    MAP_DMA_enableModule();
+    MAP_DMA_setControlBase(controlTable);
+
+    MAP_SysTick_setPeriod(TICK_MASK + 1);
+    MAP_SysTick_enableModule();
+    dma_manager_reset_counters();
+
+    for (ii = 0; ii < DMA_MANAGER_CHANNELS; ii++)
+        owners[ii] = claimed[ii];
+    for (ii = 0; ii < 3; ii++)
+        dedicated[ii] = -1;
+    softPending = 0;
+
+    for (ii = 0; ii < count; ii++)
+    {
+        const dma_client *client = &clients[ii];
+        uint32_t channel = dma_manager_channel(client->mapping);
+
+        MAP_DMA_assignChannel(client->mapping);
+        MAP_DMA_disableChannelAttribute(channel, UDMA_ATTR_ALTSELECT | UDMA_ATTR_REQMASK |
+                                        UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_USEBURST);
+
+        if (client->highPriority)
+            MAP_DMA_enableChannelAttribute(channel, UDMA_ATTR_HIGH_PRIORITY);
+        if (client->useBurst)
+            MAP_DMA_enableChannelAttribute(channel, UDMA_ATTR_USEBURST);
+
+        if (!client->handler)
+            continue;
+
+        if (lines < 3)
+        {
+            dedicated[lines] = channel;
+            MAP_DMA_assignInterrupt(dedicatedLines[lines], channel);
+            MAP_Interrupt_enableInterrupt(dedicatedInterrupts[lines]);
+            lines++;
+        }
+        else
+        {
+            shared = true;
+        }
+    }
+
+    if (shared)
+        MAP_Interrupt_enableInterrupt(INT_DMA_INT0);
+
+    return DMA_MANAGER_OK;
+}
+
+DMA_ControlTable *dma_manager_structure(uint32_t channel, bool alternate)
+{
+    return &controlTable[channel | (alternate ? UDMA_ALT_SELECT : UDMA_PRI_SELECT)];
+}
+
+const dma_client *dma_manager_owner(uint32_t channel)
+{
+    return channel < DMA_MANAGER_CHANNELS ? owners[channel] : NULL;
+}
+
+void dma_manager_pend(uint32_t channel)
+{
+    bool wasMasked = MAP_Interrupt_disableMaster();
+    uint32_t ii;
+
+    for (ii = 0; ii < 3 && dedicated[ii] != (int32_t)channel; ii++)
+        ;
+
+    if (ii < 3)
+    {
+        MAP_Interrupt_pendInterrupt(dedicatedInterrupts[ii]);
+    }
+    else
+    {
+        softPending |= 1u << channel;
+        MAP_Interrupt_pendInterrupt(INT_DMA_INT0);
+    }
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+void dma_manager_job_start(uint32_t channel)
+{
+    bool wasMasked = MAP_Interrupt_disableMaster();
+    uint32_t time = now();
+
+    if (channel < DMA_MANAGER_CHANNELS)
+    {
+        counters[channel].jobs++;
+        jobStarted[channel] = time;
+        record(channel, DMA_TRACE_JOB_START, 0, time);
+    }
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+void dma_manager_transfer(uint32_t channel, uint32_t items, uint32_t control)
+{
+    bool wasMasked = MAP_Interrupt_disableMaster();
+    uint32_t time = now();
+    uint32_t arbitration = (control & UDMA_CHCTL_ARBSIZE_M) >> UDMA_CHCTL_ARBSIZE_S;
+
+    if (channel < DMA_MANAGER_CHANNELS)
+    {
+        dma_channel_counters *counter = &counters[channel];
+
+        counter->transfers++;
+        counter->items += items;
+        if (arbitration < 11)
+            counter->arbitration[arbitration]++;
+
+        lastArmed[channel] = time;
+        armed[channel] = true;
+        record(channel, DMA_TRACE_TRANSFER, items, time);
+    }
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+void dma_manager_job_done(uint32_t channel)
+{
+    bool wasMasked = MAP_Interrupt_disableMaster();
+    uint32_t time = now();
+
+    if (channel < DMA_MANAGER_CHANNELS)
+    {
+        dma_channel_counters *counter = &counters[channel];
+        uint32_t ticks = elapsed(jobStarted[channel], time);
+
+        counter->jobTicks += ticks;
+        if (ticks > counter->maxJobTicks)
+            counter->maxJobTicks = ticks;
+        record(channel, DMA_TRACE_JOB_DONE, 0, time);
+    }
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+const dma_channel_counters *dma_manager_counters(uint32_t channel)
+{
+    return channel < DMA_MANAGER_CHANNELS ? &counters[channel] : NULL;
+}
+
+void dma_manager_reset_counters(void)
+{
+    bool wasMasked = MAP_Interrupt_disableMaster();
+    uint32_t ii;
+
+    for (ii = 0; ii < DMA_MANAGER_CHANNELS; ii++)
+    {
+        dma_channel_counters empty = {0};
+
+        counters[ii] = empty;
+        armed[ii] = false;
+    }
+#if DMA_MANAGER_TRACE_SIZE > 0
+    traceNext = 0;
+#endif
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+}
+
+uint32_t dma_manager_trace(dma_trace_entry *entries, uint32_t maxEntries)
+{
+    uint32_t copied = 0;
+#if DMA_MANAGER_TRACE_SIZE > 0
+    bool wasMasked = MAP_Interrupt_disableMaster();
+    uint32_t first = traceNext > DMA_MANAGER_TRACE_SIZE ? traceNext - DMA_MANAGER_TRACE_SIZE : 0;
+
+    /* The newest maxEntries of what the ring still holds */
+    if (traceNext - first > maxEntries)
+        first = traceNext - maxEntries;
+
+    for (; first < traceNext; first++)
+        entries[copied++] = trace[first % DMA_MANAGER_TRACE_SIZE];
+
+    if (!wasMasked)
+        MAP_Interrupt_enableMaster();
+#else
+    (void)entries;
+    (void)maxEntries;
+#endif
+    return copied;
+}
+
+void dma_manager_dump(void)
+{
+    static const char *const eventNames[] = {"start", "transfer", "interrupt", "done"};
+    uint32_t channel;
+
+    printf("DMA   jobs  transfers      items  irqs  isr avg/max  arm-irq avg/max  job avg/max\n");
+
+    for (channel = 0; channel < DMA_MANAGER_CHANNELS; channel++)
+    {
+        dma_channel_counters c;
+        bool wasMasked;
+        uint32_t jobs, irqs;
+        uint32_t ii;
+
+        if (!owners[channel])
+            continue;
+
+        /* Snapshot, so the line is consistent */
+        wasMasked = MAP_Interrupt_disableMaster();
+        c = counters[channel];
+        if (!wasMasked)
+            MAP_Interrupt_enableMaster();
+
+        jobs = c.jobs ? c.jobs : 1;
+        irqs = c.interrupts ? c.interrupts : 1;
+
+        printf("%u %-10s %6u %9u %10llu %5u %6u/%-6u %7u/%-7u %8u/%u\n",
+               channel, owners[channel]->name, c.jobs, c.transfers, (unsigned long long)c.items, c.interrupts,
+               (uint32_t)(c.isrTicks / irqs), c.maxIsrTicks,
+               (uint32_t)(c.armToIsrTicks / irqs), c.maxArmToIsrTicks,
+               (uint32_t)(c.jobTicks / jobs), c.maxJobTicks);
+
+        printf("  arbitration:");
+        for (ii = 0; ii < 11; ii++)
+            if (c.arbitration[ii])
+                printf(" %u x%u", 1u << ii, c.arbitration[ii]);
+        printf("\n");
+    }
+
+#if DMA_MANAGER_TRACE_SIZE > 0
+    {
+        static dma_trace_entry entries[DMA_MANAGER_TRACE_SIZE];
+        uint32_t count = dma_manager_trace(entries, DMA_MANAGER_TRACE_SIZE);
+        uint32_t ii;
+
+        printf("Trace, ticks after the oldest event:\n");
+        for (ii = 0; ii < count; ii++)
+            printf("%10u  ch%u %-9s %u\n", elapsed(entries[0].time, entries[ii].time),
+                   entries[ii].channel, eventNames[entries[ii].event], entries[ii].value);
+    }
+#else
+    (void)eventNames;
+#endif
+}
+
+static void dispatch(int32_t channel)
+{
+    dma_channel_counters *counter;
+    uint32_t entered, ticks;
+
+    if (channel < 0 || !owners[channel] || !owners[channel]->handler)
+        return;
+
+    counter = &counters[channel];
+    entered = now();
+
+    counter->interrupts++;
+    if (armed[channel])
+    {
+        ticks = elapsed(lastArmed[channel], entered);
+        counter->armToIsrTicks += ticks;
+        if (ticks > counter->maxArmToIsrTicks)
+            counter->maxArmToIsrTicks = ticks;
+        armed[channel] = false;
+    }
+    record(channel, DMA_TRACE_INTERRUPT, 0, entered);
+
+    owners[channel]->handler();
+
+    ticks = elapsed(entered, now());
+    counter->isrTicks += ticks;
+    if (ticks > counter->maxIsrTicks)
+        counter->maxIsrTicks = ticks;
+}
+
+void DMA_INT1_IRQHandler(void)
+{
+    dispatch(dedicated[0]);
+}
+
+void DMA_INT2_IRQHandler(void)
+{
+    dispatch(dedicated[1]);
+}
+
+void DMA_INT3_IRQHandler(void)
+{
+    dispatch(dedicated[2]);
+}
+
+static bool isDedicated(uint32_t channel)
+{
+    return dedicated[0] == (int32_t)channel || dedicated[1] == (int32_t)channel ||
+           dedicated[2] == (int32_t)channel;
+}
+
+/* Shared line. Its flags are set for every channel; the ones with a line of
+ * their own are cleared here but handled there. */
+void DMA_INT0_IRQHandler(void)
+{
+    uint32_t status = MAP_DMA_getInterruptStatus() | softPending;
+    uint32_t channel;
+
+    softPending = 0;
+
+    for (channel = 0; channel < DMA_MANAGER_CHANNELS; channel++)
+    {
+        if (status & (1u << channel))
+        {
+            MAP_DMA_clearInterruptFlag(channel);
+            if (!isDedicated(channel))
+                dispatch(channel);
+        }
+    }
+}
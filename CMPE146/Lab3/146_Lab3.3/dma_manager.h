@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * DMA channel manager
+ *
+ * Owns the DMA control table and the channel assignments. The application
+ * lists every DMA client once, with its channel mapping (DMA_CHn_xxx from
+ * driverlib), priority, burst setting and completion handler, and passes the
+ * list to dma_manager_init(). Two clients on one channel, or a channel the
+ * device does not have, are rejected there, before anything is programmed,
+ * instead of showing up later as corrupted transfers.
+ *
+ * Completion interrupts: the first three clients with a handler get the
+ * dedicated DMA_INT1..DMA_INT3 lines in list order; any further ones share
+ * DMA_INT0, whose handler dispatches by the channel status flags. Each
+ * handler runs in interrupt context for its own channel only.
+ *
+ * Priority is the high-priority channel attribute, as the uDMA has no other
+ * priority levels; among equal priorities the lower channel number wins.
+ * useBurst makes a peripheral channel answer burst requests only.
+ *
+ * Counters: clients report the jobs they start and finish and every DMA
+ * cycle they arm; the manager counts completion interrupts itself. Times are
+ * SysTick ticks (MCLK cycles), which unlike the DWT cycle counter keep
+ * running while the CPU sleeps in LPM0; SysTick wraps every 2^24 ticks, so
+ * longer intervals are not measured correctly. "Arm to interrupt" runs from
+ * arming the last cycle to entering the handler and includes the interrupt
+ * latency. With DMA_MANAGER_TRACE_SIZE > 0 the same events also go to a ring
+ * buffer of the most recent ones. dma_manager_dump() prints both to the
+ * console.
+ ******************************************************************************/
+#ifndef DMA_MANAGER_H_
+#define DMA_MANAGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* DriverLib Includes */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+
+#define DMA_MANAGER_CHANNELS    8
+
+/* Events kept in the trace, 0 to compile tracing out */
+#ifndef DMA_MANAGER_TRACE_SIZE
+#define DMA_MANAGER_TRACE_SIZE  64
+#endif
+
+typedef struct
+{
+    const char *name;
+    uint32_t mapping;           /* DMA_CHn_xxx: channel and trigger source */
+    bool highPriority;
+    bool useBurst;
+    void (*handler)(void);      /* completion, NULL if the client polls */
+} dma_client;
+
+typedef struct
+{
+    uint32_t jobs;              /* started by the client */
+    uint32_t transfers;         /* DMA cycles armed */
+    uint64_t items;
+    uint32_t interrupts;
+    uint64_t isrTicks;          /* spent in the completion handler */
+    uint32_t maxIsrTicks;
+    uint64_t armToIsrTicks;
+    uint32_t maxArmToIsrTicks;
+    uint64_t jobTicks;          /* start to completion of finished jobs */
+    uint32_t maxJobTicks;
+    uint32_t arbitration[11];   /* transfers by arbitration size 2^n */
+} dma_channel_counters;
+
+typedef enum
+{
+    DMA_TRACE_JOB_START,
+    DMA_TRACE_TRANSFER,         /* value: items */
+    DMA_TRACE_INTERRUPT,
+    DMA_TRACE_JOB_DONE
+} dma_trace_event;
+
+typedef struct
+{
+    uint32_t time;              /* SysTick, counting down */
+    uint8_t channel;
+    uint8_t event;
+    uint16_t value;
+} dma_trace_entry;
+
+typedef enum
+{
+    DMA_MANAGER_OK,
+    DMA_MANAGER_BAD_CHANNEL,    /* channel number beyond the device's */
+    DMA_MANAGER_CHANNEL_TAKEN   /* another client already has the channel */
+} dma_manager_status;
+
+/*
+ * Check the client list and, if it is consistent, enable the DMA module with
+ * the manager's control table, assign every channel, set its attributes and
+ * route its completion interrupt. On a conflict nothing is programmed and
+ * *failedClient (if not NULL) is the index of the offending client. The
+ * list must stay valid while the manager is in use.
+ */
+dma_manager_status dma_manager_init(const dma_client *clients, uint32_t count,
+                                    uint32_t *failedClient);
+
+/* Channel number of a DMA_CHn_xxx mapping */
+uint32_t dma_manager_channel(uint32_t mapping);
+
+/* Primary or alternate control structure of a channel */
+DMA_ControlTable *dma_manager_structure(uint32_t channel, bool alternate);
+
+/* Client that owns a channel, NULL if none */
+const dma_client *dma_manager_owner(uint32_t channel);
+
+/* Raise the channel's completion interrupt from software, e.g. for a
+ * transfer that finished without the DMA */
+void dma_manager_pend(uint32_t channel);
+
+/* Reported by clients: a job started, a DMA cycle of items was armed with
+ * this control word (for its arbitration size), a job finished */
+void dma_manager_job_start(uint32_t channel);
+void dma_manager_transfer(uint32_t channel, uint32_t items, uint32_t control);
+void dma_manager_job_done(uint32_t channel);
+
+const dma_channel_counters *dma_manager_counters(uint32_t channel);
+void dma_manager_reset_counters(void);
+
+/* Trace entries oldest first; returns how many were copied */
+uint32_t dma_manager_trace(dma_trace_entry *entries, uint32_t maxEntries);
+
+/* Print the counters of every owned channel and the trace */
+void dma_manager_dump(void);
+
+#endif /* DMA_MANAGER_H_ */
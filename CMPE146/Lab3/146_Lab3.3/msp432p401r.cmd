@@ -42,6 +42,11 @@
 
 --retain=flashMailbox
 
+/* Generate the CRC tables that crc32_boot.c checks at startup */
+#ifndef gen_crc_table
+#define gen_crc_table
+#endif
+
 MEMORY
 {
     MAIN       (RX) : origin = 0x00000000, length = 0x00040000
@@ -117,7 +122,7 @@ SECTIONS
     .tlvTable     : > 0x00201000
     /* BSL area for device bootstrap loader                                  */
     .bslArea      : > 0x00202000, crc_table(crc_table_for_bslArea)
-    .TI.crctab    : > MAIN
+    .TI.crctab    : > MAIN, START(crcTableStart), END(crcTableEnd)
 #endif
 
     .vtable :   > 0x20000000
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * CRC32 software engine - host benchmark
+ *
+ * Runs every software kernel of Lab2/146_Lab2.1.1/crc32_engine.c over a 64 KiB
+ * random image and reports throughput in bytes per cycle. The nibble, bytewise
+ * and slice8 kernels are the ones each CRC32_TABLE_TIER builds
+ * calculateCRC32() around, so one run covers all three tiers.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab2/146_Lab2.1.1 crc32_bench.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_engine.c -o crc32_bench
+ *     ./crc32_bench
+ *
+ * Cycles come from the time stamp counter on x86 hosts; elsewhere the
+ * benchmark falls back to nanoseconds and says so.
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "crc32_engine.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT              "cycle"
+static uint64_t benchNow(void) { return __rdtsc(); }
+#else
+#define BENCH_UNIT              "ns"
+static uint64_t benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+#define IMAGE_SIZE              (64 * 1024)
+#define REPEATS                 50
+
+typedef uint32_t (*crc32_kernel)(uint32_t crc, const uint8_t *data, uint32_t length);
+
+static uint8_t image[IMAGE_SIZE];
+
+static void runKernel(const char *name, const char *tier, crc32_kernel kernel,
+                      uint32_t reference, int repeats)
+{
+    uint64_t best = UINT64_MAX;
+    uint32_t crc = 0;
+    int i;
+
+    for (i = 0; i < repeats; i++) {
+        uint64_t t0 = benchNow();
+        crc = ~kernel(CRC32_INIT, image, IMAGE_SIZE);
+        uint64_t t1 = benchNow();
+
+        if (t1 - t0 < best)
+            best = t1 - t0;
+    }
+
+    printf("%-10s %-20s %08x %s %8.3f bytes/%s\n", name, tier, crc,
+           crc == reference ? "ok  " : "FAIL",
+           (double)IMAGE_SIZE / (double)best, BENCH_UNIT);
+}
+
+int main(void)
+{
+    int i;
+
+    srand(146);
+    for (i = 0; i < IMAGE_SIZE; i++)
+        image[i] = rand();
+
+    uint32_t reference = ~crc32_update_bitwise(CRC32_INIT, image, IMAGE_SIZE);
+
+    printf("CRC32 over %u bytes, best of %d runs\n\n", IMAGE_SIZE, REPEATS);
+
+    runKernel("bitwise", "(original)", crc32_update_bitwise, reference, REPEATS / 10);
+    runKernel("nibble", "CRC32_TIER_NIBBLE", crc32_update_nibble, reference, REPEATS);
+    runKernel("bytewise", "CRC32_TIER_BYTE", crc32_update_bytewise, reference, REPEATS);
+    runKernel("slice4", "", crc32_update_slice4, reference, REPEATS);
+    runKernel("slice8", "CRC32_TIER_SLICE8", crc32_update_slice8, reference, REPEATS);
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * CRC32 single-bit error correction - host check and benchmark
+ *
+ * Flips random bits in random messages and repairs them with
+ * Lab2/146_Lab2.1.1/crc32_correct.c, comparing the syndrome lookup (plain
+ * table and baby-step/giant-step strides) with the brute-force search that
+ * flips every bit and recomputes the CRC. Every repair is checked: the
+ * located bit must be the flipped one and the repaired message must match
+ * the original. Two-bit errors must be rejected and a bad bit in the stored
+ * CRC must be reported as such. Exits non-zero on any failure.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab2/146_Lab2.1.1 crc32_correct_bench.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_correct.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_engine.c -o crc32_correct_bench
+ *     ./crc32_correct_bench
+ *
+ * Cycles come from the time stamp counter on x86 hosts; elsewhere the
+ * benchmark falls back to nanoseconds and says so.
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc32_engine.h"
+#include "crc32_correct.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT              "cycles"
+static uint64_t benchNow(void) { return __rdtsc(); }
+#else
+#define BENCH_UNIT              "ns"
+static uint64_t benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+#define MAX_LENGTH              4096
+#define TRIALS                  200
+#define BRUTE_TRIALS            10
+
+static uint8_t message[MAX_LENGTH];
+static uint8_t original[MAX_LENGTH];
+static crc32_syndrome_entry entries[CRC32_CORRECT_ENTRIES(MAX_LENGTH, 1)];
+
+static int failures;
+
+static void check(int ok, const char *what, uint32_t length, int32_t bit)
+{
+    if (!ok) {
+        printf("FAIL: %s (length %u, bit %d)\n", what, length, bit);
+        failures++;
+    }
+}
+
+static void randomMessage(uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+        original[i] = rand();
+    memcpy(message, original, length);
+}
+
+/* Round trips through crc32_correct() for random lengths and positions */
+static void checkCorrector(const crc32_corrector *corrector, uint32_t maxLength)
+{
+    int t;
+
+    for (t = 0; t < TRIALS; t++) {
+        uint32_t length = 1 + rand() % maxLength;
+        int32_t bit = rand() % (8 * length);
+        int32_t other = (bit + 1 + rand() % (8 * length - 1)) % (8 * length);
+        int32_t found = -1;
+
+        randomMessage(length);
+        uint32_t crc = calculateCRC32(message, length);
+
+        check(crc32_correct(corrector, message, length, crc, &found) == CRC32_CORRECT_OK,
+              "clean message", length, -1);
+
+        message[bit / 8] ^= 1 << (bit % 8);
+        check(crc32_correct(corrector, message, length, crc, &found) == CRC32_CORRECT_FIXED &&
+              found == bit && memcmp(message, original, length) == 0,
+              "single-bit repair", length, bit);
+
+        check(crc32_correct(corrector, message, length, crc ^ (1u << (bit % 32)), &found) ==
+              CRC32_CORRECT_CRC_FIELD, "bad bit in the CRC", length, bit);
+
+        if (8 * length > 1) {
+            message[bit / 8] ^= 1 << (bit % 8);
+            message[other / 8] ^= 1 << (other % 8);
+            check(crc32_correct(corrector, message, length, crc, &found) == CRC32_CORRECT_FAILED,
+                  "two-bit error rejected", length, bit);
+        }
+    }
+}
+
+static void benchLookup(const char *name, uint32_t stride, uint32_t length)
+{
+    crc32_corrector corrector;
+    uint64_t t0, t1, total = 0;
+    int t;
+
+    t0 = benchNow();
+    crc32_correct_init(&corrector, entries, length, stride);
+    t1 = benchNow();
+
+    checkCorrector(&corrector, length);
+
+    for (t = 0; t < TRIALS; t++) {
+        int32_t bit = rand() % (8 * length);
+
+        randomMessage(length);
+        uint32_t crc = calculateCRC32(original, length);
+        message[bit / 8] ^= 1 << (bit % 8);
+        uint32_t syndrome = calculateCRC32(message, length) ^ crc;
+
+        uint64_t s0 = benchNow();
+        int32_t found = crc32_correct_locate(&corrector, length, syndrome);
+        uint64_t s1 = benchNow();
+
+        check(found == bit, name, length, bit);
+        total += s1 - s0;
+    }
+
+    printf("%-14s stride %4u %6u entries %8u bytes  init %10llu  locate %10.0f %s\n",
+           name, stride, corrector.count, (uint32_t)(corrector.count * sizeof(entries[0])),
+           (unsigned long long)(t1 - t0), (double)total / TRIALS, BENCH_UNIT);
+}
+
+static void benchBruteForce(uint32_t length)
+{
+    uint64_t total = 0;
+    int t;
+
+    for (t = 0; t < BRUTE_TRIALS; t++) {
+        int32_t bit = rand() % (8 * length);
+
+        randomMessage(length);
+        uint32_t crc = calculateCRC32(original, length);
+        message[bit / 8] ^= 1 << (bit % 8);
+
+        uint64_t s0 = benchNow();
+        int32_t found = crc32_correct_bruteforce(message, length, crc);
+        uint64_t s1 = benchNow();
+
+        check(found == bit, "brute force", length, bit);
+        total += s1 - s0;
+    }
+
+    printf("%-74s locate %10.0f %s\n", "brute force",
+           (double)total / BRUTE_TRIALS, BENCH_UNIT);
+}
+
+int main(void)
+{
+    static const uint32_t lengths[] = { 256, 1024, MAX_LENGTH };
+    uint32_t i;
+
+    srand(146);
+
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        uint32_t length = lengths[i];
+
+        printf("\nSingle-bit error in %u bytes, mean of %d errors\n", length, TRIALS);
+        benchLookup("lookup", 1, length);
+        benchLookup("bsgs", 16, length);
+        benchLookup("bsgs", 64, length);
+        benchLookup("bsgs", 256, length);
+        benchBruteForce(length);
+    }
+
+    printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,376 @@
+/*******************************************************************************
+ * Rolling-checksum delta tool
+ *
+ * Host side of Lab2/146_Lab2.1.1/crc32_delta.h: takes the block signatures a
+ * device reported for its current image and the new image, and writes the
+ * delta to send over the link: references to blocks the device already has
+ * and literal bytes for the rest.
+ *
+ *     crc32_delta sign <image> <block size> <signatures>   (what the device does)
+ *     crc32_delta diff <signatures> <new image> <delta>
+ *     crc32_delta apply <old image> <delta> <new image>
+ *     crc32_delta selftest
+ *
+ * selftest edits random images (byte changes, insertions, deletions), runs
+ * sign/diff/apply in memory and exits non-zero if any rebuilt image differs.
+ *
+ * Build from this directory:
+ *
+ *     gcc -O2 -I../Lab2/146_Lab2.1.1 crc32_delta.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_delta.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_engine.c -o crc32_delta
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crc32_engine.h"
+#include "crc32_delta.h"
+
+typedef struct
+{
+    uint8_t *data;
+    uint32_t length;
+    uint32_t size;
+} buffer;
+
+typedef struct
+{
+    uint32_t weak;
+    uint32_t index;
+} weak_entry;
+
+static void put(buffer *out, const void *data, uint32_t length)
+{
+    if (out->length + length > out->size) {
+        out->size = 2 * (out->length + length);
+        out->data = realloc(out->data, out->size);
+        if (!out->data) {
+            perror("realloc");
+            exit(2);
+        }
+    }
+
+    memcpy(out->data + out->length, data, length);
+    out->length += length;
+}
+
+static void put32(buffer *out, uint32_t value)
+{
+    uint8_t le[4] = { value, value >> 8, value >> 16, value >> 24 };
+
+    put(out, le, 4);
+}
+
+static int compareWeak(const void *a, const void *b)
+{
+    uint32_t wa = ((const weak_entry *)a)->weak, wb = ((const weak_entry *)b)->weak;
+
+    return (wa > wb) - (wa < wb);
+}
+
+/* Index of a block with this weak and strong checksum, or -1 */
+static int32_t findBlock(const weak_entry *index, uint32_t count, const crc32_delta_sig *sigs,
+                         uint32_t weak, const uint8_t *window, uint32_t blockSize)
+{
+    uint32_t lo = 0, hi = count;
+    uint32_t strong = 0;
+    int haveStrong = 0;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+
+        if (index[mid].weak < weak)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (; lo < count && index[lo].weak == weak; lo++) {
+        if (!haveStrong) {
+            strong = calculateCRC32((uint8_t *)window, blockSize);
+            haveStrong = 1;
+        }
+        if (sigs[index[lo].index].strong == strong)
+            return (int32_t)index[lo].index;
+    }
+
+    return -1;
+}
+
+static void flushCopy(buffer *out, int32_t *first, uint32_t *count)
+{
+    if (*count) {
+        put(out, &(uint8_t){ CRC32_DELTA_OP_COPY }, 1);
+        put32(out, (uint32_t)*first);
+        put32(out, *count);
+        *count = 0;
+    }
+}
+
+static void flushLiteral(buffer *out, const uint8_t *start, uint32_t length)
+{
+    if (length) {
+        put(out, &(uint8_t){ CRC32_DELTA_OP_LITERAL }, 1);
+        put32(out, length);
+        put(out, start, length);
+    }
+}
+
+static buffer makeDelta(const crc32_delta_sig *sigs, uint32_t count, uint32_t blockSize,
+                        const uint8_t *image, uint32_t length)
+{
+    weak_entry *index = malloc((count ? count : 1) * sizeof(*index));
+    buffer out = { NULL, 0, 0 };
+    uint32_t pos = 0, literalStart = 0;
+    uint32_t copyCount = 0;
+    int32_t copyFirst = 0;
+    uint32_t weak = 0;
+    int weakValid = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        index[i].weak = sigs[i].weak;
+        index[i].index = i;
+    }
+    qsort(index, count, sizeof(*index), compareWeak);
+
+    put32(&out, CRC32_DELTA_MAGIC);
+    put32(&out, blockSize);
+    put32(&out, length);
+    put32(&out, calculateCRC32((uint8_t *)image, length));
+
+    while (pos + blockSize <= length) {
+        int32_t block;
+
+        if (!weakValid) {
+            weak = crc32_delta_weak(image + pos, blockSize);
+            weakValid = 1;
+        }
+
+        block = findBlock(index, count, sigs, weak, image + pos, blockSize);
+        if (block >= 0) {
+            flushLiteral(&out, image + literalStart, pos - literalStart);
+
+            if (copyCount && block != copyFirst + (int32_t)copyCount)
+                flushCopy(&out, &copyFirst, &copyCount);
+            if (!copyCount)
+                copyFirst = block;
+            copyCount++;
+
+            pos += blockSize;
+            literalStart = pos;
+            weakValid = 0;
+            continue;
+        }
+
+        flushCopy(&out, &copyFirst, &copyCount);
+
+        /* No match: slide the window one byte */
+        if (pos + blockSize < length)
+            weak = crc32_delta_roll(weak, image[pos], image[pos + blockSize], blockSize);
+        pos++;
+    }
+
+    flushCopy(&out, &copyFirst, &copyCount);
+    flushLiteral(&out, image + literalStart, length - literalStart);
+
+    free(index);
+    return out;
+}
+
+static buffer sign(const uint8_t *image, uint32_t length, uint32_t blockSize)
+{
+    uint32_t maxSigs = length / blockSize;
+    crc32_delta_sig *sigs = malloc((maxSigs ? maxSigs : 1) * sizeof(*sigs));
+    crc32_delta_signer signer;
+    buffer out = { NULL, 0, 0 };
+    uint32_t offset, count;
+
+    /* Feed odd-sized fragments like a device streaming its flash */
+    crc32_delta_sign_init(&signer, blockSize, sigs, maxSigs, CRC32_ENGINE_SW);
+    for (offset = 0; offset < length; offset += 37)
+        crc32_delta_sign_update(&signer, image + offset, length - offset < 37 ? length - offset : 37);
+    count = crc32_delta_sign_final(&signer);
+
+    out.size = 12 + 8 * count;
+    out.data = malloc(out.size);
+    out.length = crc32_delta_serialize(sigs, count, blockSize, out.data, out.size);
+
+    free(sigs);
+    return out;
+}
+
+static buffer diff(const buffer *report, const uint8_t *image, uint32_t length)
+{
+    uint32_t maxSigs = report->length / 8 + 1;
+    crc32_delta_sig *sigs = malloc(maxSigs * sizeof(*sigs));
+    uint32_t blockSize;
+    int32_t count = crc32_delta_deserialize(report->data, report->length, &blockSize, sigs, maxSigs);
+    buffer out;
+
+    if (count < 0) {
+        fprintf(stderr, "malformed signature report\n");
+        exit(2);
+    }
+
+    out = makeDelta(sigs, (uint32_t)count, blockSize, image, length);
+    free(sigs);
+    return out;
+}
+
+static buffer readFile(const char *path)
+{
+    buffer in = { NULL, 0, 0 };
+    uint8_t chunk[4096];
+    size_t n;
+    FILE *f = fopen(path, "rb");
+
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        put(&in, chunk, (uint32_t)n);
+    fclose(f);
+
+    return in;
+}
+
+static void writeFile(const char *path, const buffer *out)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (!f || fwrite(out->data, 1, out->length, f) != out->length) {
+        perror(path);
+        exit(2);
+    }
+    fclose(f);
+}
+
+static int selftest(void)
+{
+    static const uint32_t blockSizes[] = { 16, 64, 256 };
+    int failures = 0;
+    int t;
+
+    srand(146);
+
+    for (t = 0; t < 300; t++) {
+        uint32_t blockSize = blockSizes[t % 3];
+        uint32_t oldLength = 1 + rand() % 20000;
+        uint8_t *old = malloc(oldLength);
+        uint8_t *new = malloc(oldLength + 2000);
+        uint32_t newLength = 0, i, edits = rand() % 8;
+        uint32_t src = 0;
+
+        for (i = 0; i < oldLength; i++)
+            old[i] = rand();
+
+        /* Copy old to new with a few changes, insertions and deletions */
+        while (src < oldLength) {
+            uint32_t run = rand() % (oldLength / (edits + 1) + 1) + 1;
+            uint32_t k;
+
+            if (run > oldLength - src)
+                run = oldLength - src;
+            memcpy(new + newLength, old + src, run);
+            newLength += run;
+            src += run;
+
+            switch (edits ? rand() % 4 : 3) {
+            case 0:
+                if (newLength)
+                    new[rand() % newLength] ^= 1 + rand() % 255;
+                break;
+            case 1:
+                for (k = rand() % 100; k && newLength < oldLength + 1900; k--)
+                    new[newLength++] = rand();
+                break;
+            case 2:
+                src += rand() % 100;
+                break;
+            }
+            if (edits)
+                edits--;
+        }
+
+        buffer report = sign(old, oldLength, blockSize);
+        buffer delta = diff(&report, new, newLength);
+        uint8_t *rebuilt = malloc(newLength + 1);
+        int32_t rebuiltLength = crc32_delta_apply(old, oldLength, delta.data, delta.length,
+                                                  rebuilt, newLength + 1);
+
+        if (rebuiltLength != (int32_t)newLength || memcmp(rebuilt, new, newLength) != 0) {
+            printf("FAIL: image %d (%u -> %u bytes, block %u)\n", t, oldLength, newLength, blockSize);
+            failures++;
+        }
+
+        free(old);
+        free(new);
+        free(rebuilt);
+        free(report.data);
+        free(delta.data);
+    }
+
+    printf("%s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 2 && strcmp(argv[1], "selftest") == 0)
+        return selftest();
+
+    if (argc == 5 && strcmp(argv[1], "sign") == 0) {
+        buffer image = readFile(argv[2]);
+        uint32_t blockSize = (uint32_t)strtoul(argv[3], NULL, 0);
+        buffer report;
+
+        if (blockSize == 0) {
+            fprintf(stderr, "block size must be positive\n");
+            return 2;
+        }
+        report = sign(image.data, image.length, blockSize);
+        writeFile(argv[4], &report);
+        return 0;
+    }
+
+    if (argc == 5 && strcmp(argv[1], "diff") == 0) {
+        buffer report = readFile(argv[2]);
+        buffer image = readFile(argv[3]);
+        buffer delta = diff(&report, image.data, image.length);
+
+        writeFile(argv[4], &delta);
+        printf("%u byte image -> %u byte delta (%.1f%%)\n", image.length, delta.length,
+               image.length ? 100.0 * delta.length / image.length : 0.0);
+        return 0;
+    }
+
+    if (argc == 5 && strcmp(argv[1], "apply") == 0) {
+        buffer old = readFile(argv[2]);
+        buffer delta = readFile(argv[3]);
+        buffer image = { NULL, 0, 0 };
+        int32_t length;
+
+        image.size = delta.length >= 12 ? delta.data[8] | delta.data[9] << 8 |
+                     delta.data[10] << 16 | (uint32_t)delta.data[11] << 24 : 0;
+        image.data = malloc(image.size + 1);
+        length = crc32_delta_apply(old.data, old.length, delta.data, delta.length,
+                                   image.data, image.size);
+        if (length < 0) {
+            fprintf(stderr, "delta does not apply to this image\n");
+            return 1;
+        }
+        image.length = (uint32_t)length;
+        writeFile(argv[4], &image);
+        return 0;
+    }
+
+    fprintf(stderr, "usage: crc32_delta sign <image> <block size> <signatures>\n"
+                    "       crc32_delta diff <signatures> <new image> <delta>\n"
+                    "       crc32_delta apply <old image> <delta> <new image>\n"
+                    "       crc32_delta selftest\n");
+    return 2;
+}
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * CRC32-hashed map - host check and benchmark
+ *
+ * Runs random put/get/remove sequences on Lab2/146_Lab2.1.1/crc32_hashmap.c
+ * against a brute-force shadow table, then times lookups with the CRC32
+ * hash (software engine on the host) and with FNV-1a, for 4-byte sensor IDs
+ * and 16-byte session IDs. Exits non-zero on any mismatch. On the device,
+ * Lab2.1.1 times the same lookups with the CRC32 module.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab2/146_Lab2.1.1 crc32_hashmap_bench.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_hashmap.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_engine.c -o crc32_hashmap_bench
+ *     ./crc32_hashmap_bench
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc32_hashmap.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT              "cycles"
+static uint64_t benchNow(void) { return __rdtsc(); }
+#else
+#define BENCH_UNIT              "ns"
+static uint64_t benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+#define CAPACITY                1024
+#define MAX_KEY                 16
+#define OPERATIONS              200000
+#define KEY_RANGE               900         /* distinct keys in the check */
+#define LOOKUPS                 100000
+
+static uint32_t hashes[CAPACITY];
+static uint32_t values[CAPACITY];
+static uint8_t keys[CAPACITY * MAX_KEY];
+
+static uint8_t shadowPresent[KEY_RANGE];
+static uint32_t shadowValue[KEY_RANGE];
+static uint8_t lookupKeys[CAPACITY * 3 / 4][MAX_KEY];
+
+static volatile uint32_t sink;
+static int failures;
+
+static void makeKey(uint8_t *key, uint32_t id, uint32_t keySize)
+{
+    memset(key, 0, keySize);
+    memcpy(key, &id, keySize < 4 ? keySize : 4);
+}
+
+static void checkMap(crc32_hashmap_hash_fn hash, const char *name)
+{
+    crc32_hashmap map;
+    uint8_t key[MAX_KEY];
+    uint32_t count = 0;
+    int i;
+
+    crc32_hashmap_init(&map, hashes, values, keys, CAPACITY, MAX_KEY, hash);
+    memset(shadowPresent, 0, sizeof(shadowPresent));
+
+    for (i = 0; i < OPERATIONS; i++) {
+        uint32_t id = rand() % KEY_RANGE;
+        uint32_t value = rand(), found;
+        int op = rand() % 3;
+
+        makeKey(key, id, MAX_KEY);
+
+        if (op == 0) {
+            int ok = crc32_hashmap_put(&map, key, value);
+
+            if (ok) {
+                count += !shadowPresent[id];
+                shadowPresent[id] = 1;
+                shadowValue[id] = value;
+            } else if (shadowPresent[id] || 4 * (count + 1) <= 3 * CAPACITY) {
+                failures++;
+            }
+        } else if (op == 1) {
+            int ok = crc32_hashmap_get(&map, key, &found);
+
+            if (ok != shadowPresent[id] || (ok && found != shadowValue[id]))
+                failures++;
+        } else {
+            int ok = crc32_hashmap_remove(&map, key);
+
+            if (ok != shadowPresent[id])
+                failures++;
+            count -= shadowPresent[id];
+            shadowPresent[id] = 0;
+        }
+
+        if (map.count != count)
+            failures++;
+    }
+
+    if (failures)
+        printf("FAIL: %s map disagrees with the shadow table\n", name);
+}
+
+static void benchLookups(crc32_hashmap_hash_fn hash, const char *name, uint32_t keySize)
+{
+    uint32_t n = sizeof(lookupKeys) / sizeof(lookupKeys[0]);
+    crc32_hashmap map;
+    uint32_t i, value, hits = 0;
+    uint64_t t0, t1, h0, h1;
+
+    crc32_hashmap_init(&map, hashes, values, keys, CAPACITY, keySize, hash);
+
+    for (i = 0; i < n; i++) {
+        uint32_t b;
+
+        for (b = 0; b < keySize; b++)
+            lookupKeys[i][b] = rand();
+        crc32_hashmap_put(&map, lookupKeys[i], i);
+    }
+
+    t0 = benchNow();
+    for (i = 0; i < LOOKUPS; i++)
+        hits += crc32_hashmap_get(&map, lookupKeys[i % n], &value) && value == i % n;
+    t1 = benchNow();
+
+    h0 = benchNow();
+    for (i = 0; i < LOOKUPS; i++)
+        sink += hash(lookupKeys[i % n], keySize);
+    h1 = benchNow();
+
+    if (hits != LOOKUPS) {
+        printf("FAIL: %s lost keys\n", name);
+        failures++;
+    }
+
+    printf("%-8s %2u-byte keys: lookup %6.1f %s, hash alone %6.1f %s\n", name, keySize,
+           (double)(t1 - t0) / LOOKUPS, BENCH_UNIT, (double)(h1 - h0) / LOOKUPS, BENCH_UNIT);
+}
+
+int main(void)
+{
+    srand(146);
+
+    checkMap(NULL, "crc32");
+    checkMap(crc32_hashmap_fnv1a, "fnv1a");
+
+    printf("%u slots at 3/4 load, mean of %u lookups\n\n", CAPACITY, LOOKUPS);
+
+    benchLookups(crc32_hash, "crc32", 4);
+    benchLookups(crc32_hashmap_fnv1a, "fnv1a", 4);
+    benchLookups(crc32_hash, "crc32", 16);
+    benchLookups(crc32_hashmap_fnv1a, "fnv1a", 16);
+
+    printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+
+    return failures ? 1 : 0;
+}
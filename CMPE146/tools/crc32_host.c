@@ -0,0 +1,281 @@
+/*******************************************************************************
+ * CRC32 for host tooling
+ *
+ * The PCLMULQDQ kernel follows Gopal et al., "Fast CRC Computation for
+ * Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009): four
+ * 128-bit lanes are folded 64 bytes ahead, merged into one lane, folded
+ * 16 bytes at a time and Barrett-reduced to 32 bits. The constants are the
+ * bit-reflected x^n mod P values for the CRC-32 polynomial from the paper.
+ * Buffers shorter than 64 bytes and the unaligned tail go through the
+ * portable kernel.
+ *
+ * The accelerated kernels are compiled with per-function target attributes,
+ * so the file needs no -m flags and still runs on CPUs without them.
+ ******************************************************************************/
+#include "crc32_host.h"
+#include "crc32_engine.h"
+#include "crc_generic.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CRC32_HOST_X86
+#include <immintrin.h>
+#endif
+
+/* Largest block handed to the 32-bit length device kernels at once */
+#define PORTABLE_CHUNK          0x40000000u
+
+static int crc32Kernel = -1;
+static int crc32cKernel = -1;
+
+uint32_t crc32_host_update_portable(uint32_t crc, const uint8_t *data, size_t length)
+{
+    while (length)
+    {
+        uint32_t chunk = length > PORTABLE_CHUNK ? PORTABLE_CHUNK : (uint32_t)length;
+
+        crc = crc32_update(crc, data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+
+    return crc;
+}
+
+uint32_t crc32c_host_update_portable(uint32_t crc, const uint8_t *data, size_t length)
+{
+    while (length)
+    {
+        uint32_t chunk = length > PORTABLE_CHUNK ? PORTABLE_CHUNK : (uint32_t)length;
+
+        crc = crc_update(&crc32cParams, crc, data, chunk);
+        data += chunk;
+        length -= chunk;
+    }
+
+    return crc;
+}
+
+#ifdef CRC32_HOST_X86
+
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t foldBlocks(uint32_t crc, const uint8_t *data, size_t length)
+{
+    static const uint64_t k1k2[2] __attribute__((aligned(16))) = { 0x0154442bd4, 0x01c6e41596 };
+    static const uint64_t k3k4[2] __attribute__((aligned(16))) = { 0x01751997d0, 0x00ccaa009e };
+    static const uint64_t k5k0[2] __attribute__((aligned(16))) = { 0x0163cd6124, 0x0000000000 };
+    static const uint64_t poly[2] __attribute__((aligned(16))) = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+    /* length is a multiple of 16 and at least 64 */
+    x1 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+
+    data += 64;
+    length -= 64;
+
+    /* Fold four lanes 64 bytes ahead */
+    while (length >= 64)
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        y5 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+        y6 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+        y7 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+        y8 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+        data += 64;
+        length -= 64;
+    }
+
+    /* Merge the lanes */
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* Remaining 16-byte blocks */
+    while (length >= 16)
+    {
+        x2 = _mm_loadu_si128((const __m128i *)data);
+
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+        data += 16;
+        length -= 16;
+    }
+
+    /* 128 to 64 bits */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x0 = _mm_load_si128((const __m128i *)poly);
+
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+uint32_t crc32_host_update_pclmul(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (length >= 64)
+    {
+        size_t blocks = length & ~(size_t)15;
+
+        crc = foldBlocks(crc, data, blocks);
+        data += blocks;
+        length -= blocks;
+    }
+
+    return crc32_host_update_portable(crc, data, length);
+}
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_host_update_sse42(uint32_t crc, const uint8_t *data, size_t length)
+{
+    while (length && ((uintptr_t)data & 7))
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+        length--;
+    }
+
+#if defined(__x86_64__)
+    {
+        uint64_t crc64 = crc;
+
+        for (; length >= 8; data += 8, length -= 8)
+            crc64 = _mm_crc32_u64(crc64, *(const uint64_t *)data);
+
+        crc = (uint32_t)crc64;
+    }
+#endif
+
+    for (; length >= 4; data += 4, length -= 4)
+        crc = _mm_crc32_u32(crc, *(const uint32_t *)data);
+
+    while (length--)
+        crc = _mm_crc32_u8(crc, *data++);
+
+    return crc;
+}
+
+static void detect(void)
+{
+    __builtin_cpu_init();
+
+    crc32Kernel = (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) ?
+                  CRC32_HOST_PCLMUL : CRC32_HOST_PORTABLE;
+    crc32cKernel = __builtin_cpu_supports("sse4.2") ? CRC32_HOST_SSE42 : CRC32_HOST_PORTABLE;
+}
+
+#else
+
+uint32_t crc32_host_update_pclmul(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return crc32_host_update_portable(crc, data, length);
+}
+
+uint32_t crc32c_host_update_sse42(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return crc32c_host_update_portable(crc, data, length);
+}
+
+static void detect(void)
+{
+    crc32Kernel = CRC32_HOST_PORTABLE;
+    crc32cKernel = CRC32_HOST_PORTABLE;
+}
+
+#endif
+
+crc32_host_kernel crc32_host_kernel_used(void)
+{
+    if (crc32Kernel < 0)
+        detect();
+
+    return (crc32_host_kernel)crc32Kernel;
+}
+
+crc32_host_kernel crc32c_host_kernel_used(void)
+{
+    if (crc32cKernel < 0)
+        detect();
+
+    return (crc32_host_kernel)crc32cKernel;
+}
+
+const char *crc32_host_kernel_name(crc32_host_kernel kernel)
+{
+    static const char *const names[] = { "portable", "sse4.2", "pclmulqdq" };
+
+    return names[kernel];
+}
+
+uint32_t crc32_host_update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (crc32_host_kernel_used() == CRC32_HOST_PCLMUL)
+        return crc32_host_update_pclmul(crc, data, length);
+
+    return crc32_host_update_portable(crc, data, length);
+}
+
+uint32_t crc32_host(const uint8_t *data, size_t length)
+{
+    return ~crc32_host_update(CRC32_INIT, data, length);
+}
+
+uint32_t crc32c_host_update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (crc32c_host_kernel_used() == CRC32_HOST_SSE42)
+        return crc32c_host_update_sse42(crc, data, length);
+
+    return crc32c_host_update_portable(crc, data, length);
+}
+
+uint32_t crc32c_host(const uint8_t *data, size_t length)
+{
+    return ~crc32c_host_update(CRC32_INIT, data, length);
+}
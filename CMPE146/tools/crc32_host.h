@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * CRC32 for host tooling
+ *
+ * Computes the same CRC-32 the device checks with calculateCRC32(), for build
+ * and release tools that hash many firmware images. The fastest kernel the
+ * CPU supports is picked at the first call:
+ *
+ *     CRC32_HOST_PCLMUL     carry-less multiply folding, 64 bytes per step
+ *     CRC32_HOST_PORTABLE   slicing-by-8 from crc32_engine.c
+ *
+ * SSE4.2's crc32 instruction implements CRC-32C (Castagnoli), not the
+ * CRC-32 of the CRC32 module, so it backs the crc32c_host_* functions, which
+ * match crc32cParams of crc_generic.h, with a table fallback.
+ *
+ * The *_update functions work on the raw register like crc32_update():
+ * seed with CRC32_INIT and invert the result, or use crc32_host() and
+ * crc32c_host() for whole buffers. Link with crc32_engine.c and
+ * crc_generic.c from Lab2/146_Lab2.1.1.
+ ******************************************************************************/
+#ifndef CRC32_HOST_H_
+#define CRC32_HOST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum
+{
+    CRC32_HOST_PORTABLE,
+    CRC32_HOST_SSE42,
+    CRC32_HOST_PCLMUL
+} crc32_host_kernel;
+
+/* Kernels the dispatching functions use on this CPU */
+crc32_host_kernel crc32_host_kernel_used(void);
+crc32_host_kernel crc32c_host_kernel_used(void);
+const char *crc32_host_kernel_name(crc32_host_kernel kernel);
+
+/* CRC-32/ISO-HDLC, identical to calculateCRC32() */
+uint32_t crc32_host_update(uint32_t crc, const uint8_t *data, size_t length);
+uint32_t crc32_host(const uint8_t *data, size_t length);
+
+/* CRC-32C/Castagnoli */
+uint32_t crc32c_host_update(uint32_t crc, const uint8_t *data, size_t length);
+uint32_t crc32c_host(const uint8_t *data, size_t length);
+
+/* Individual kernels, for tests and benchmarks. The accelerated ones must
+ * only be called when the CPU has the instructions. */
+uint32_t crc32_host_update_portable(uint32_t crc, const uint8_t *data, size_t length);
+uint32_t crc32_host_update_pclmul(uint32_t crc, const uint8_t *data, size_t length);
+uint32_t crc32c_host_update_portable(uint32_t crc, const uint8_t *data, size_t length);
+uint32_t crc32c_host_update_sse42(uint32_t crc, const uint8_t *data, size_t length);
+
+#endif /* CRC32_HOST_H_ */
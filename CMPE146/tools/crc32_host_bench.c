@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * CRC32 host library - check and benchmark
+ *
+ * Checks every kernel of crc32_host.c against the standard check values and
+ * against the device code (calculateCRC32() and crc_calculate() with
+ * crc32cParams) for random lengths and alignments, then reports throughput
+ * next to the device's bitwise and slicing-by-8 kernels. Every preset of
+ * crc_generic.c is also checked against its check value, whole and streamed
+ * in two parts, and its table kernel against the bitwise one. Exits non-zero
+ * on any mismatch.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab2/146_Lab2.1.1 crc32_host_bench.c crc32_host.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_engine.c \
+ *         ../Lab2/146_Lab2.1.1/crc_generic.c -o crc32_host_bench
+ *     ./crc32_host_bench
+ *
+ * Kernels the CPU does not support are skipped.
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc32_engine.h"
+#include "crc_generic.h"
+#include "crc32_host.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT              "cycle"
+static uint64_t benchNow(void) { return __rdtsc(); }
+#else
+#define BENCH_UNIT              "ns"
+static uint64_t benchNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+#define IMAGE_SIZE              (1024 * 1024)
+#define REPEATS                 20
+#define TRIALS                  2000
+
+typedef uint32_t (*host_kernel)(uint32_t crc, const uint8_t *data, size_t length);
+
+static uint8_t image[IMAGE_SIZE + 16];
+static int failures;
+
+static uint32_t bitwiseKernel(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return crc32_update_bitwise(crc, data, (uint32_t)length);
+}
+
+static uint32_t slice8Kernel(uint32_t crc, const uint8_t *data, size_t length)
+{
+    return crc32_update(crc, data, (uint32_t)length);
+}
+
+static void checkKernel(const char *name, host_kernel kernel, const crc_params *params,
+                        uint32_t checkValue)
+{
+    uint32_t crc = ~kernel(CRC32_INIT, (const uint8_t *)"123456789", 9);
+    int t;
+
+    if (crc != checkValue) {
+        printf("FAIL: %s check value %08x, expected %08x\n", name, crc, checkValue);
+        failures++;
+    }
+
+    for (t = 0; t < TRIALS; t++) {
+        uint32_t length = rand() % 4096;
+        uint32_t offset = rand() % 16;
+        uint32_t expected = params == &crc32Params ?
+                            calculateCRC32(image + offset, length) :
+                            crc_calculate(params, image + offset, length);
+
+        crc = ~kernel(CRC32_INIT, image + offset, length);
+        if (crc != expected) {
+            printf("FAIL: %s length %u offset %u: %08x, expected %08x\n",
+                   name, length, offset, crc, expected);
+            failures++;
+            return;
+        }
+    }
+}
+
+/* CRC of "123456789", streamed split at every point, and table against
+ * bitwise kernel on random data */
+static void checkPreset(const char *name, const crc_params *params, uint32_t checkValue)
+{
+    const uint8_t *check = (const uint8_t *)"123456789";
+    crc_params bitwise = *params;
+    uint32_t crc = crc_calculate(params, check, 9);
+    uint32_t split;
+    int t;
+
+    if (crc != checkValue) {
+        printf("FAIL: %s check value %08x, expected %08x\n", name, crc, checkValue);
+        failures++;
+    }
+
+    for (split = 0; split <= 9; split++) {
+        crc = crc_update(params, crc_init(params), check, split);
+        crc = crc_final(params, crc_update(params, crc, check + split, 9 - split));
+        if (crc != checkValue) {
+            printf("FAIL: %s streamed at %u: %08x, expected %08x\n", name, split, crc, checkValue);
+            failures++;
+        }
+    }
+
+    bitwise.table = NULL;
+    for (t = 0; t < TRIALS; t++) {
+        uint32_t length = rand() % 512;
+        uint32_t offset = rand() % 16;
+        uint32_t expected = crc_calculate(&bitwise, image + offset, length);
+
+        crc = crc_calculate(params, image + offset, length);
+        if (crc != expected) {
+            printf("FAIL: %s length %u offset %u: %08x, bitwise %08x\n",
+                   name, length, offset, crc, expected);
+            failures++;
+            return;
+        }
+    }
+}
+
+static void runKernel(const char *name, host_kernel kernel, int repeats)
+{
+    uint64_t best = UINT64_MAX;
+    int i;
+
+    for (i = 0; i < repeats; i++) {
+        uint64_t t0 = benchNow();
+        volatile uint32_t crc = kernel(CRC32_INIT, image, IMAGE_SIZE);
+        uint64_t t1 = benchNow();
+
+        (void)crc;
+        if (t1 - t0 < best)
+            best = t1 - t0;
+    }
+
+    printf("%-26s %8.3f bytes/%s\n", name, (double)IMAGE_SIZE / (double)best, BENCH_UNIT);
+}
+
+int main(void)
+{
+    int pclmul = crc32_host_kernel_used() == CRC32_HOST_PCLMUL;
+    int sse42 = crc32c_host_kernel_used() == CRC32_HOST_SSE42;
+    int i;
+
+    srand(146);
+    for (i = 0; i < (int)sizeof(image); i++)
+        image[i] = rand();
+
+    printf("CRC-32 kernel: %s, CRC-32C kernel: %s\n",
+           crc32_host_kernel_name(crc32_host_kernel_used()),
+           crc32_host_kernel_name(crc32c_host_kernel_used()));
+
+    checkPreset("CRC-8/SMBUS", &crc8Params, 0xF4);
+    checkPreset("CRC-16/CCITT-FALSE", &crc16CcittParams, 0x29B1);
+    checkPreset("CRC-32/ISO-HDLC", &crc32Params, 0xCBF43926);
+    checkPreset("CRC-32C", &crc32cParams, 0xE3069283);
+
+    checkKernel("crc32 portable", crc32_host_update_portable, &crc32Params, 0xCBF43926);
+    checkKernel("crc32 dispatch", crc32_host_update, &crc32Params, 0xCBF43926);
+    if (pclmul)
+        checkKernel("crc32 pclmulqdq", crc32_host_update_pclmul, &crc32Params, 0xCBF43926);
+    checkKernel("crc32c portable", crc32c_host_update_portable, &crc32cParams, 0xE3069283);
+    checkKernel("crc32c dispatch", crc32c_host_update, &crc32cParams, 0xE3069283);
+    if (sse42)
+        checkKernel("crc32c sse4.2", crc32c_host_update_sse42, &crc32cParams, 0xE3069283);
+
+    printf("\nThroughput over %u bytes, best of %d runs\n\n", IMAGE_SIZE, REPEATS);
+
+    runKernel("crc32 bitwise (device)", bitwiseKernel, 2);
+    runKernel("crc32 slice8 (device)", slice8Kernel, REPEATS);
+    if (pclmul)
+        runKernel("crc32 pclmulqdq", crc32_host_update_pclmul, REPEATS);
+    runKernel("crc32c table", crc32c_host_update_portable, REPEATS);
+    if (sse42)
+        runKernel("crc32c sse4.2", crc32c_host_update_sse42, REPEATS);
+
+    printf("\n%s\n", failures ? "FAILED" : "all checks passed");
+
+    return failures ? 1 : 0;
+}
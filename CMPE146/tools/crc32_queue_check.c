@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * CRC32 DMA job queue - host check
+ *
+ * Runs Lab3/146_Lab3.3/crc32_queue.c against a simulated DMA channel: a
+ * transfer moves SIM_BURST bytes per tick into the software CRC32 and raises
+ * its completion interrupt when done, which runs at once unless interrupts
+ * are masked, in which case it stays pending until they are unmasked or
+ * the queue sleeps. Random submits, ticks and waits are interleaved, and
+ * some callbacks submit follow-up jobs from the interrupt. Checks every
+ * result against calculateCRC32(), that callbacks come in submission order,
+ * that the next job is already running when a callback is called, that a
+ * full queue rejects jobs and that the DMA never idles with work queued.
+ * A simulated arbiter lets another client take the CRC32 module while the
+ * queue is idle; the queue must then reject jobs, must own the module
+ * exactly while it has jobs and must ignore that client's completions. Exits non-zero on failure.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab3/146_Lab3.3 crc32_queue_check.c \
+ *         ../Lab3/146_Lab3.3/crc32_queue.c \
+ *         ../Lab3/146_Lab3.3/crc32_engine.c -o crc32_queue_check
+ *     ./crc32_queue_check
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crc32_engine.h"
+#include "crc32_queue.h"
+
+#define SIM_BURST               64
+#define POOL_SIZE               8192
+#define MAX_JOBS                20000
+
+static uint8_t pool[POOL_SIZE];
+
+/* Simulated channel */
+static bool simBusy;
+static crc32_job simJob;
+static uint32_t simDone;                /* bytes moved */
+static uint32_t simCrc;
+static bool simMasked;
+static bool simPending;
+
+/* Simulated arbiter: the queue or another client may own the CRC32 module */
+static bool simOwned;
+static bool simForeign;
+
+/* Expected results and callback order, by handle */
+static uint32_t expected[MAX_JOBS + 1];
+static uint32_t lastCallback;
+static uint32_t submitted;
+static int failures;
+
+static void check(int ok, const char *what)
+{
+    if (!ok && failures++ < 10)
+        printf("FAIL: %s\n", what);
+}
+
+static void simInterrupt(void)
+{
+    simMasked = true;
+    simPending = false;
+    simBusy = false;
+    crc32_queue_complete();
+    simMasked = false;
+}
+
+bool crc32_queue_port_acquire(void)
+{
+    check(!simOwned, "module acquired twice");
+
+    if (simForeign)
+        return false;
+
+    simOwned = true;
+    return true;
+}
+
+void crc32_queue_port_release(void)
+{
+    check(simOwned, "module released without owning it");
+    check(!simBusy, "module released with a job running");
+    simOwned = false;
+}
+
+void crc32_queue_port_start(const crc32_job *job)
+{
+    check(!simBusy, "job started while the channel is busy");
+    check(simOwned, "job started without owning the module");
+    check(job->type != CRC32_JOB_TASKS, "task lists are not simulated");
+
+    simJob = *job;
+    simDone = 0;
+    simCrc = job->seed;
+    simBusy = true;
+}
+
+uint32_t crc32_queue_port_result(void)
+{
+    return simCrc;
+}
+
+bool crc32_queue_port_lock(void)
+{
+    bool wasLocked = simMasked;
+
+    simMasked = true;
+    return wasLocked;
+}
+
+void crc32_queue_port_unlock(bool wasLocked)
+{
+    simMasked = wasLocked;
+
+    if (!simMasked && simPending)
+        simInterrupt();
+}
+
+static void simTick(void)
+{
+    uint32_t chunk;
+
+    if (!simBusy || simPending)
+        return;
+
+    chunk = simJob.length - simDone < SIM_BURST ? simJob.length - simDone : SIM_BURST;
+    simCrc = crc32_update(simCrc, (const uint8_t *)simJob.data + simDone, chunk);
+    simDone += chunk;
+
+    if (simDone == simJob.length) {
+        simPending = true;
+        if (!simMasked)
+            simInterrupt();
+    }
+}
+
+/* WFI with interrupts masked: run until an interrupt is pending, take it */
+void crc32_queue_port_sleep(void)
+{
+    check(simMasked, "sleep with interrupts unmasked");
+    check(simBusy, "sleep with nothing running");
+
+    while (simBusy && !simPending)
+        simTick();
+
+    if (simPending)
+        simInterrupt();
+    simMasked = true;
+}
+
+static uint32_t submitRandom(void);
+
+static void callback(uint32_t handle, uint32_t result, void *arg)
+{
+    check(handle == lastCallback + 1, "callbacks out of order");
+    lastCallback = handle;
+
+    check(result == expected[handle], "job result");
+    check(crc32_queue_pending() == 0 || simBusy, "next job not started before the callback");
+
+    /* Chain a follow-up job from the interrupt */
+    if (arg && submitted < MAX_JOBS)
+        submitRandom();
+}
+
+static uint32_t submitRandom(void)
+{
+    crc32_job job;
+    uint32_t length = rand() % 8 == 0 ? rand() % 4 : rand() % 3000;
+    uint32_t offset = rand() % (POOL_SIZE - length + 1);
+    uint32_t pending = crc32_queue_pending();
+    uint32_t handle;
+
+    job.type = rand() % 2 ? CRC32_JOB_BYTES : CRC32_JOB_WORDS;
+    job.data = pool + offset;
+    job.length = length;
+    job.seed = rand() % 2 ? CRC32_INIT : (uint32_t)rand();
+    job.callback = callback;
+    job.arg = rand() % 4 == 0 ? &job : NULL;
+
+    handle = crc32_queue_submit(&job);
+    if (pending == CRC32_QUEUE_DEPTH) {
+        check(handle == 0, "full queue accepted a job");
+        return 0;
+    }
+    if (pending == 0 && simForeign) {
+        check(handle == 0, "idle queue accepted a job while the module is taken");
+        return 0;
+    }
+
+    check(handle == submitted + 1, "handles are not sequential");
+    submitted = handle;
+    expected[handle] = crc32_update(job.seed, pool + offset, length);
+    return handle;
+}
+
+int main(void)
+{
+    uint32_t ii;
+
+    srand(146);
+    for (ii = 0; ii < POOL_SIZE; ii++)
+        pool[ii] = rand();
+
+    crc32_queue_init();
+
+    while (submitted < MAX_JOBS) {
+        switch (rand() % 5) {
+        case 0:
+            submitRandom();
+            break;
+        case 1:
+        case 2:
+            for (ii = rand() % 64; ii; ii--)
+                simTick();
+            break;
+        case 3:
+            if (submitted) {
+                uint32_t handle = submitted - rand() % (submitted < 16 ? submitted : 16);
+
+                if (!crc32_queue_done(handle) || handle + CRC32_QUEUE_DEPTH > submitted)
+                    check(crc32_queue_wait(handle) == expected[handle], "wait result");
+                check(crc32_queue_done(handle), "wait returned early");
+            }
+            break;
+        case 4:
+            /* Another client takes or returns the module, if it can, and
+             * may finish a transfer of its own while the queue is idle */
+            simForeign = !simOwned && rand() % 3 == 0;
+            if (crc32_queue_pending() == 0) {
+                uint32_t before = lastCallback;
+
+                simInterrupt();
+                check(crc32_queue_pending() == 0 && lastCallback == before,
+                      "idle queue took a foreign completion");
+            }
+            break;
+        }
+
+        check(crc32_queue_pending() == 0 || simBusy, "DMA idle with jobs queued");
+        check(simOwned == (crc32_queue_pending() != 0), "module owned without jobs or vice versa");
+    }
+
+    crc32_queue_wait(submitted);
+    check(lastCallback == submitted, "missing callbacks");
+    check(crc32_queue_pending() == 0, "queue not empty");
+    check(!simOwned, "module not handed back");
+
+    printf("%u jobs, %s\n", submitted, failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * Scatter-gather task lists - host check
+ *
+ * Builds task lists with Lab3/146_Lab3.3/crc32_sg.c for random fragment lists
+ * and runs them through a model of the uDMA memory scatter-gather cycle: each
+ * task is decoded from its control word like the controller does, its bytes
+ * go to the software CRC32 and the chain stops at the first auto task. The
+ * result must equal the CRC32 of the concatenated fragments, every task must
+ * target the destination register and only the last one may be auto. Also
+ * checks the 1024-byte split and the task limit. Exits non-zero on failure.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab3/146_Lab3.3 crc32_sg_check.c \
+ *         ../Lab3/146_Lab3.3/crc32_sg.c \
+ *         ../Lab3/146_Lab3.3/crc32_engine.c -o crc32_sg_check
+ *     ./crc32_sg_check
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crc32_engine.h"
+#include "crc32_sg.h"
+
+#define MAX_FRAGMENTS           8
+#define POOL_SIZE               65536
+
+static uint8_t pool[POOL_SIZE];
+static volatile uint32_t crcRegister;
+static crc32_sg_task tasks[CRC32_SG_MAX_TASKS];
+static int failures;
+
+static void check(int ok, const char *what)
+{
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/* Run the chain; returns the CRC32 fed through it, tasks run in *executed */
+static uint32_t runTasks(const crc32_sg_task *list, uint32_t count, uint32_t *executed)
+{
+    uint32_t crc = CRC32_INIT;
+    uint32_t ii;
+
+    for (ii = 0; ii < count; ii++) {
+        uint32_t control = list[ii].control;
+        uint32_t items = ((control & CRC32_SG_COUNT_MASK) >> CRC32_SG_COUNT_SHIFT) + 1;
+        uint32_t mode = control & CRC32_SG_MODE_MASK;
+        const uint8_t *source = (const uint8_t *)list[ii].srcEnd - (items - 1);
+
+        check(list[ii].dstEnd == &crcRegister, "task does not target the CRC register");
+        check((control & ~(CRC32_SG_COUNT_MASK | CRC32_SG_MODE_MASK)) ==
+              (CRC32_SG_DST_INC_NONE | CRC32_SG_ARB_1024), "unexpected size/increment/arbitration");
+
+        crc = crc32_update(crc, source, items);
+
+        if (mode == CRC32_SG_MODE_AUTO) {
+            *executed = ii + 1;
+            return ~crc;
+        }
+        check(mode == CRC32_SG_MODE_MEM_ALT, "task is neither scatter-gather nor auto");
+    }
+
+    check(0, "chain does not end in an auto task");
+    *executed = count;
+    return ~crc;
+}
+
+int main(void)
+{
+    crc32_sg_fragment fragments[MAX_FRAGMENTS];
+    uint8_t joined[MAX_FRAGMENTS * 3000];
+    uint32_t ii, count, taskCount, executed;
+    int t;
+
+    srand(146);
+    for (ii = 0; ii < POOL_SIZE; ii++)
+        pool[ii] = rand();
+
+    for (t = 0; t < 10000; t++) {
+        uint32_t expectedTasks = 0, joinedLength = 0;
+
+        count = 1 + rand() % MAX_FRAGMENTS;
+        for (ii = 0; ii < count; ii++) {
+            uint32_t length = rand() % 4 == 0 ? 0 : 1 + rand() % 3000;
+            uint32_t offset = rand() % (POOL_SIZE - length + 1);
+
+            fragments[ii].data = pool + offset;
+            fragments[ii].length = length;
+            memcpy(joined + joinedLength, pool + offset, length);
+            joinedLength += length;
+            expectedTasks += (length + 1023) / 1024;
+        }
+
+        taskCount = crc32_sg_build(fragments, count, &crcRegister, tasks, CRC32_SG_MAX_TASKS);
+        check(taskCount == expectedTasks, "task count");
+
+        if (taskCount) {
+            uint32_t crc = runTasks(tasks, taskCount, &executed);
+
+            check(executed == taskCount, "chain ended early");
+            check(crc == calculateCRC32(joined, joinedLength), "CRC of the chain");
+        }
+    }
+
+    /* Exactly 1024 bytes is one task, 1025 two */
+    fragments[0].data = pool;
+    fragments[0].length = 1024;
+    check(crc32_sg_build(fragments, 1, &crcRegister, tasks, CRC32_SG_MAX_TASKS) == 1, "1024-byte split");
+    fragments[0].length = 1025;
+    check(crc32_sg_build(fragments, 1, &crcRegister, tasks, CRC32_SG_MAX_TASKS) == 2, "1025-byte split");
+
+    /* Too many tasks for the list or for the primary structure */
+    check(crc32_sg_build(fragments, 1, &crcRegister, tasks, 1) == 0, "maxTasks limit");
+    for (ii = 0; ii < MAX_FRAGMENTS; ii++) {
+        fragments[ii].data = pool;
+        fragments[ii].length = POOL_SIZE;
+    }
+    check(crc32_sg_build(fragments, MAX_FRAGMENTS, &crcRegister, tasks, 1000) == 0,
+          "CRC32_SG_MAX_TASKS limit");
+
+    printf("%s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
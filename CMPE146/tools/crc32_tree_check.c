@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * CRC32 block tree - host check
+ *
+ * Builds trees with Lab2/146_Lab2.1.1/crc32_tree.c over random images of
+ * random length and block size and checks that the root equals
+ * calculateCRC32() of the flat image, that crc32_tree_update_block() after
+ * rewriting blocks gives the same tree as a rebuild, that crc32_tree_diff()
+ * against the original tree reports exactly the rewritten blocks in order,
+ * and that serialize/deserialize round-trips while rejecting short buffers,
+ * a bad magic and too little node storage. Exits non-zero on failure.
+ *
+ * Build and run from this directory:
+ *
+ *     gcc -O2 -I../Lab2/146_Lab2.1.1 crc32_tree_check.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_tree.c \
+ *         ../Lab2/146_Lab2.1.1/crc32_engine.c -o crc32_tree_check
+ *     ./crc32_tree_check
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crc32_engine.h"
+#include "crc32_tree.h"
+
+#define IMAGE_SIZE              20000
+#define MAX_LEAVES              IMAGE_SIZE
+#define MAX_NODES               CRC32_TREE_MAX_NODES(MAX_LEAVES)
+#define MAX_CHANGED             8
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t original[IMAGE_SIZE];
+static uint32_t nodes[MAX_NODES];
+static uint32_t referenceNodes[MAX_NODES];
+static uint32_t rebuiltNodes[MAX_NODES];
+static uint32_t loadedNodes[MAX_NODES];
+static uint8_t serialized[CRC32_TREE_HEADER_SIZE + 4 * MAX_NODES];
+static int failures;
+
+static void check(int ok, const char *what)
+{
+    if (!ok && failures++ < 10)
+        printf("FAIL: %s\n", what);
+}
+
+static int compareBlocks(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/* Rewrite up to MAX_CHANGED distinct blocks; returns them sorted */
+static uint32_t changeBlocks(const crc32_tree *tree, uint32_t *changed)
+{
+    uint32_t count = 0, want = 1 + rand() % MAX_CHANGED;
+    uint32_t jj;
+
+    while (count < want && count < tree->leafCount) {
+        uint32_t block = rand() % tree->leafCount;
+        uint32_t start = block * tree->blockSize;
+        uint32_t length = tree->length - start < tree->blockSize ?
+                          tree->length - start : tree->blockSize;
+
+        for (jj = 0; jj < count && changed[jj] != block; jj++)
+            ;
+        if (jj < count)
+            continue;
+
+        /* One flipped bit always changes the block CRC */
+        image[start + rand() % length] ^= 1u << (rand() % 8);
+        changed[count++] = block;
+    }
+
+    qsort(changed, count, sizeof(changed[0]), compareBlocks);
+    return count;
+}
+
+int main(void)
+{
+    crc32_tree tree, reference, rebuilt, loaded;
+    uint32_t changed[MAX_CHANGED], bad[MAX_CHANGED];
+    uint32_t ii;
+    int t;
+
+    srand(146);
+
+    for (t = 0; t < 2000; t++) {
+        uint32_t length = 1 + rand() % IMAGE_SIZE;
+        uint32_t blockSize = rand() % 4 == 0 ? 1 + rand() % 16 : 1 + rand() % 2048;
+        uint32_t count, badCount, size;
+
+        for (ii = 0; ii < length; ii++)
+            image[ii] = rand();
+        memcpy(original, image, length);
+
+        crc32_tree_init(&reference, referenceNodes, length, blockSize);
+        crc32_tree_build(&reference, image);
+        check(reference.nodeCount <= CRC32_TREE_MAX_NODES(reference.leafCount), "node bound");
+        check(crc32_tree_root(&reference) == calculateCRC32(image, length), "root of a fresh tree");
+
+        /* Incremental update against a full rebuild */
+        crc32_tree_init(&tree, nodes, length, blockSize);
+        memcpy(nodes, referenceNodes, reference.nodeCount * sizeof(nodes[0]));
+
+        count = changeBlocks(&tree, changed);
+        for (ii = 0; ii < count; ii++)
+            crc32_tree_update_block(&tree, image, changed[ii]);
+
+        crc32_tree_init(&rebuilt, rebuiltNodes, length, blockSize);
+        crc32_tree_build(&rebuilt, image);
+        check(memcmp(nodes, rebuiltNodes, tree.nodeCount * sizeof(nodes[0])) == 0,
+              "updated tree differs from a rebuild");
+        check(crc32_tree_root(&tree) == calculateCRC32(image, length), "root after updates");
+
+        /* Diff finds exactly the rewritten blocks, in block order */
+        badCount = crc32_tree_diff(&tree, &reference, bad, MAX_CHANGED);
+        check(badCount == count, "diff count");
+        check(badCount != count || memcmp(bad, changed, count * sizeof(bad[0])) == 0,
+              "diff blocks");
+        check(crc32_tree_diff(&rebuilt, &tree, bad, MAX_CHANGED) == 0, "diff of equal trees");
+
+        /* A short list still gets the first blocks and the full count */
+        memset(bad, 0xff, sizeof(bad));
+        check(crc32_tree_diff(&tree, &reference, bad, 1) == count && bad[0] == changed[0] &&
+              (count < 2 || bad[1] == 0xffffffffu), "diff with a short list");
+
+        /* A tree of another geometry cannot be matched block by block */
+        crc32_tree_init(&rebuilt, rebuiltNodes, length, blockSize + 1);
+        crc32_tree_build(&rebuilt, original);
+        badCount = crc32_tree_diff(&tree, &rebuilt, bad, MAX_CHANGED);
+        check(badCount == tree.leafCount, "geometry mismatch count");
+        for (ii = 0; ii < badCount && ii < MAX_CHANGED; ii++)
+            check(bad[ii] == ii, "geometry mismatch blocks");
+        check(crc32_tree_root(&rebuilt) == calculateCRC32(original, length),
+              "root with another block size");
+
+        /* Serialization round trip */
+        size = crc32_tree_serialize(&tree, serialized, sizeof(serialized));
+        check(size == CRC32_TREE_HEADER_SIZE + 4 * tree.nodeCount, "serialized size");
+        check(crc32_tree_serialize(&tree, serialized, size - 1) == 0, "short output accepted");
+
+        check(crc32_tree_deserialize(&loaded, loadedNodes, MAX_NODES, serialized, size),
+              "deserialize");
+        check(loaded.length == length && loaded.blockSize == blockSize &&
+              loaded.nodeCount == tree.nodeCount &&
+              memcmp(loadedNodes, nodes, tree.nodeCount * sizeof(nodes[0])) == 0,
+              "round trip");
+        check(crc32_tree_diff(&loaded, &tree, bad, MAX_CHANGED) == 0, "diff after round trip");
+
+        check(!crc32_tree_deserialize(&loaded, loadedNodes, MAX_NODES, serialized, size - 1),
+              "truncated input accepted");
+        check(!crc32_tree_deserialize(&loaded, loadedNodes, tree.nodeCount - 1, serialized, size),
+              "too few nodes accepted");
+        serialized[0] ^= 1;
+        check(!crc32_tree_deserialize(&loaded, loadedNodes, MAX_NODES, serialized, size),
+              "bad magic accepted");
+    }
+
+    printf("%d trees, %s\n", t, failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}